@@ -198,6 +198,18 @@ namespace eutelescope {
      */
     bool _syncTriggerID;
 
+    //! Read-ahead depth
+    /*! Number of events a background thread reads and converts
+     *  ahead of the one being processed. With -1 it is twice the
+     *  number of cores.
+     */
+    int _readAhead;
+
+    //! Number of data events to skip at the beginning of the file
+    /*! The run begin and end events are not skipped.
+     */
+    int _skipEvents;
+
   private:
     // from here below only private data members
 
@@ -30,6 +30,7 @@
 #include <eudaq/FileReader.hh>
 #include <eudaq/Event.hh>
 #include <eudaq/Logger.hh>
+#include <eudaq/LCEventQueue.hh>
 
 // lcio includes
 #include <IMPL/LCCollectionVec.h>
@@ -43,6 +44,9 @@
 #include <iostream>
 #include <cassert>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
 
 #include "config.h" // for version symbols
 
@@ -60,7 +64,8 @@ EUTelNativeReader::EUTelNativeReader()
     : DataSourceProcessor("EUTelNativeReader"), _depfetOutputCollectionName(""),
       _eudrbRawModeOutputCollectionName(""),
       _eudrbZSModeOutputCollectionName(""), _fileName(""), _geoID(0),
-      _syncTriggerID(0), _depfetDetectors(), _eudrbDetectors(), _tluDetectors(),
+      _syncTriggerID(0), _readAhead(-1), _skipEvents(0),
+      _depfetDetectors(), _eudrbDetectors(), _tluDetectors(),
       _eudrbConsecutiveOutOfSyncWarning(0), _eudrbPreviousOutOfSyncEvent(0),
       _eudrbSparsePixelType(0), _eudrbTotalOutOfSyncEvent(0) {
   // initialize few variables
@@ -96,6 +101,17 @@ EUTelNativeReader::EUTelNativeReader()
                            "This is the depfet produced output collection",
                            _depfetOutputCollectionName, string("rawdata_dep"));
 
+  registerOptionalParameter("ReadAhead",
+                            "Number of events read and converted ahead of "
+                            "the one being processed, -1 for twice the "
+                            "number of cores",
+                            _readAhead, static_cast<int>(-1));
+
+  registerOptionalParameter("SkipEvents",
+                            "Number of data events to skip at the "
+                            "beginning of the file",
+                            _skipEvents, static_cast<int>(0));
+
   registerOptionalParameter("EUDRBSparsePixelType",
                             "Type of sparsified pixel data structure (use "
                             "SparsePixelType enumerator)",
@@ -143,18 +159,62 @@ void EUTelNativeReader::readDataSource(int numEvents) {
     throw ParseException("Problems with reading file " + _fileName);
   }
 
+  // a background thread reads the file and queues the events for the
+  // conversion on the eudaq thread pool, while Marlin processes the
+  // converted ones in their original order
+  size_t lookahead = _readAhead < 0 ? 2 * std::thread::hardware_concurrency() + 1
+                                    : static_cast<size_t>(_readAhead);
+  LCEventQueue queue(lookahead, nullptr);
+  std::atomic<bool> stopReading(false);
+  std::exception_ptr readError;
+  std::thread readThread([&]() {
+    try {
+      // the native format has no index to seek with, so skipped events
+      // are only deserialized; the run begin and end events are kept
+      int skipped = 0;
+      while (skipped < _skipEvents && !stopReading) {
+        auto ev = reader->GetNextEvent();
+        if (!ev)
+          break;
+        if (!ev->IsBORE() && !ev->IsEORE())
+          ++skipped;
+        else if (!queue.Push(ev))
+          break;
+      }
+      while (!stopReading) {
+        auto ev = reader->GetNextEvent();
+        if (!ev || !queue.Push(ev))
+          break;
+      }
+    } catch (...) {
+      readError = std::current_exception();
+    }
+    queue.Close();
+  });
+  auto stopReader = [&]() {
+    stopReading = true;
+    queue.Close();
+    if (readThread.joinable())
+      readThread.join();
+  };
+
   while (eventCounter < numEvents) {
-    auto ev = reader->GetNextEvent();
-    if(!ev)
-      break;
-    LCEventSP lcEvent(new lcio::LCEventImpl);
-    LCEventConverter::Convert(ev, lcEvent, nullptr);
+    LCEventQueue::Item item;
+    try {
+      if (!queue.Pop(item))
+        break;
+    } catch (...) {
+      stopReader();
+      throw;
+    }
+    LCEventSP lcEvent = item.lcev;
     if (lcEvent == NULL) {
       streamlog_out(ERROR1)
             << "The eudaq plugin manager is not able to create a valid LCEvent"
             << endl
             << "Check that eudaq was compiled with LCIO and EUTELESCOPE active "
             << endl;
+        stopReader();
         throw MissingLibraryException(this, "eudaq");
     }
     if (lcEvent->getParameters().getIntVal(
@@ -171,9 +231,17 @@ void EUTelNativeReader::readDataSource(int numEvents) {
 				sync" <<  endl;*/
       continue;
     }
-    ProcessorMgr::instance()->processEvent(lcEvent.get());
+    try {
+      ProcessorMgr::instance()->processEvent(lcEvent.get());
+    } catch (...) {
+      stopReader();
+      throw;
+    }
     ++eventCounter;
   }
+  stopReader();
+  if (readError)
+    std::rethrow_exception(readError);
 }
 
 void EUTelNativeReader::end() {
@@ -0,0 +1,51 @@
+#include "eudaq/OptionParser.hh"
+#include "eudaq/ProcessorPipeline.hh"
+#include "eudaq/Configuration.hh"
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+int main(int /*argc*/, const char **argv) {
+  eudaq::OptionParser op("EUDAQ Command Line Pipeline", "2.0", "Runs a processor pipeline described in a configuration file");
+  eudaq::Option<std::string> conf_path(op, "c", "config", "", "string",
+				       "pipeline configuration file");
+  eudaq::Option<uint32_t> duration(op, "t", "time", 0, "seconds",
+				   "stop the sources after this time, 0 to wait until they end");
+  eudaq::OptionFlag print(op, "p", "print", "print the processor graph");
+
+  try{
+    op.Parse(argv);
+  }
+  catch (...) {
+    return op.HandleMainException();
+  }
+
+  auto conf = eudaq::Configuration::MakeUniqueReadFile(conf_path.Value());
+  if(!conf){
+    std::cout<<"can not read the pipeline configuration "<<conf_path.Value()<<", option --help to get help"<<std::endl;
+    return 1;
+  }
+  std::unique_ptr<eudaq::ProcessorPipeline> pipeline;
+  try{
+    pipeline.reset(new eudaq::ProcessorPipeline(*conf));
+  }
+  catch (const std::exception &e){
+    std::cout<<e.what()<<std::endl;
+    return 1;
+  }
+  if(print.Value())
+    pipeline->Print(std::cout);
+
+  auto tp_start = std::chrono::steady_clock::now();
+  pipeline->Start();
+  if(duration.Value()){
+    std::this_thread::sleep_for(std::chrono::seconds(duration.Value()));
+    pipeline->Stop();
+  }
+  else{
+    pipeline->Wait();
+  }
+  std::chrono::duration<double> du = std::chrono::steady_clock::now() - tp_start;
+  std::cout<<"pipeline done in "<<du.count()<<" s"<<std::endl;
+  return 0;
+}
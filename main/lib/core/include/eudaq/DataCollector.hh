@@ -9,6 +9,8 @@
 #include "eudaq/Utils.hh"
 #include "eudaq/Platform.hh"
 #include "eudaq/Factory.hh"
+#include "eudaq/EventSpillQueue.hh"
+#include "eudaq/LatencyHistogram.hh"
 
 #include <string>
 #include <vector>
@@ -48,6 +50,11 @@ namespace eudaq {
     static DataCollectorSP Make(const std::string &code_name,
 				const std::string &run_name,
 				const std::string &runcontrol);
+  protected:
+    EventSpillQueueSP CreateEventQueue(const std::string &stream);
+    void RemoveEventQueue(EventSpillQueueSP que);
+    void BalanceEventQueues();
+    bool IsEventQueueTimedOut(EventSpillQueueSP que) const;
   private:
     void OnInitialise() override final;
     void OnConfigure() override final;
@@ -70,6 +77,16 @@ namespace eudaq {
     uint32_t m_evt_c;
     uint32_t m_fraction;
     ConfigurationSPC m_conf;
+    std::mutex m_mtx_queue;
+    std::vector<EventSpillQueueSP> m_queues;
+    uint32_t m_queue_c;
+    uint64_t m_mem_limit;
+    uint32_t m_stall_timeout;
+    std::string m_spill_path;
+    std::string m_stalled;
+    bool m_stamp;
+    LatencyHistogram m_lat_receive;
+    LatencyHistogram m_lat_write;
   };
   //----------DOC-MARK-----END*DEC-----DOC-MARK----------
 }
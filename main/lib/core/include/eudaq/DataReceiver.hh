@@ -6,6 +6,7 @@
 #include "eudaq/Event.hh"
 #include "eudaq/FileWriter.hh"
 #include "eudaq/DataSender.hh"
+#include "eudaq/EventSelection.hh"
 #include "eudaq/Configuration.hh"
 #include "eudaq/Utils.hh"
 #include "eudaq/Platform.hh"
@@ -22,6 +23,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <type_traits>
+#include <chrono>
 
 namespace eudaq {
   class DataReceiver;
@@ -37,8 +39,11 @@ namespace eudaq {
     virtual void OnReceive(ConnectionSPC id, EventSP ev);
     std::string Listen(const std::string &addr);
     void StopListen();//TODO: remove this method later
+    void SetEventSelection(const EventSelection &sel);
+    EventSelection GetEventSelection() const;
   private:
     void DataHandler(TransportEvent &ev);
+    void SendFeedback();
     bool Deamon();
     bool AsyncReceiving();
     bool AsyncForwarding();
@@ -57,6 +62,12 @@ namespace eudaq {
     std::mutex m_mx_deamon;
     std::queue<std::pair<EventSP, ConnectionSPC>> m_qu_ev;
     std::condition_variable m_cv_not_empty;
+    mutable std::mutex m_mx_sel;
+    EventSelection m_sel;
+    std::atomic<bool> m_sel_changed;
+    std::atomic<uint64_t> m_consumed_c;
+    uint64_t m_consumed_last;
+    std::chrono::steady_clock::time_point m_tp_feedback;
   };
   //----------DOC-MARK-----END*DEC-----DOC-MARK----------
 }
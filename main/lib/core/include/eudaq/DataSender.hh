@@ -4,7 +4,9 @@
 
 #include "eudaq/Platform.hh"
 #include "eudaq/Event.hh"
+#include "eudaq/EventSelection.hh"
 #include <string>
+#include <chrono>
 #include <future>
 #include <thread>
 #include <queue>
@@ -21,8 +23,13 @@ class TransportClient;
       ~DataSender();
       void Connect(const std::string & server);
       void SendEvent(EventSPC ev);
+      EventSelection GetEventSelection() const;
+      uint32_t GetSampling() const;
   private:
       bool AsyncSending();
+      bool Select(const Event &ev);
+      void ReadFeedback();
+      void AdaptSampling(double consumed, uint64_t backlog);
       std::string m_type, m_name;
       std::unique_ptr<TransportClient> m_dataclient;
       uint64_t m_packetCounter;
@@ -31,6 +38,13 @@ class TransportClient;
       std::mutex m_mx_qu_ev; 
       std::queue<EventSPC> m_qu_ev;
       std::condition_variable m_cv_not_empty;
+      EventSelection m_sel;
+      uint32_t m_sampling;
+      uint64_t m_sel_c;
+      uint64_t m_offered_c;
+      uint64_t m_backlog;
+      std::chrono::steady_clock::time_point m_tp_poll;
+      std::chrono::steady_clock::time_point m_tp_feedback;
   };
 
 }
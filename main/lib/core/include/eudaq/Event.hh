@@ -5,6 +5,8 @@
 #include <vector>
 #include <map>
 #include <ostream>
+#include <cstring>
+#include <type_traits>
 
 #include "eudaq/Serializable.hh"
 #include "eudaq/Serializer.hh"
@@ -13,6 +15,7 @@
 #include "eudaq/Utils.hh"
 #include "eudaq/Platform.hh"
 #include "eudaq/Factory.hh"
+#include "eudaq/TagKey.hh"
 
 namespace eudaq {
   class Event;
@@ -54,6 +57,27 @@ namespace eudaq {
     void SetTag(const std::string &name, const std::string &val);
     std::string GetTag(const std::string &name, const std::string &def = "") const;
     std::map<std::string, std::string> GetTags() const;
+
+    /// Typed tags are stored and serialised as numbers or bytes under the id
+    /// of an interned key; they can also be read by name with GetTag
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type
+    SetTag(const TagKey &key, T val){
+      SetTypedTag(key, std::is_signed<T>::value ? TAG_INT : TAG_UINT,
+		  std::is_signed<T>::value ? uint64_t(int64_t(val)) : uint64_t(val));
+    }
+    void SetTag(const TagKey &key, double val);
+    void SetTag(const TagKey &key, const std::vector<uint8_t> &val);
+    bool HasTag(const TagKey &key) const;
+    std::string GetTag(const TagKey &key, const std::string &def = "") const;
+    std::string GetTag(const TagKey &key, const char *def) const;
+    template <typename T> T GetTag(const TagKey &key, T def) const {
+      const TypedTag *tag = FindTypedTag(key.GetId());
+      if(tag)
+	return TypedTagValue(*tag, def, std::is_arithmetic<T>());
+      return GetTag(key.GetName(), def);
+    }
+    std::vector<uint8_t> GetTagBytes(const TagKey &key) const;
     
     void SetFlagBit(uint32_t f);
     void ClearFlagBit(uint32_t f);
@@ -116,9 +140,13 @@ namespace eudaq {
 
     //from RawdataEvent
     std::vector<uint8_t> GetBlock(uint32_t i) const;
+    /// Data block without a copy, valid while the event is not modified
+    const std::vector<uint8_t> &GetBlockRef(uint32_t i) const;
     size_t GetNumBlock() const;
     size_t NumBlocks() const;
     std::vector<uint32_t> GetBlockNumList() const;
+    /// Approximate number of bytes held by this event, sub-events included
+    size_t GetDataSize() const;
     
     /// Add a data block as std::vector
     template <typename T>
@@ -144,6 +172,9 @@ namespace eudaq {
     //TODO: remove, clearn up
     std::string GetTag(const std::string &name, const char *def) const;
     template <typename T> T GetTag(const std::string & name, T def) const {
+      const TypedTag *tag = m_typed_tags.empty() ? nullptr : FindTypedTag(str2hash(name));
+      if(tag)
+	return TypedTagValue(*tag, def, std::is_arithmetic<T>());
       return eudaq::from_string(GetTag(name), def);
     }
     template <typename T> void SetTag(const std::string &name, const T &val) {
@@ -151,6 +182,43 @@ namespace eudaq {
     }
     
   private:
+    enum TagType {
+      TAG_UINT = 1,
+      TAG_INT = 2,
+      TAG_DOUBLE = 3,
+      TAG_BYTES = 4,
+      TAG_UINT32 = 5 // serialised form of a TAG_UINT below 2^32
+    };
+    struct TypedTag {
+      uint32_t key;
+      uint32_t type;
+      uint64_t value;
+      std::vector<uint8_t> bytes;
+    };
+    TypedTag &SetTypedTag(const TagKey &key, TagType type, uint64_t value);
+    const TypedTag *FindTypedTag(uint32_t key) const;
+    static std::string FormatTypedTag(const TypedTag &tag);
+    template <typename T>
+    static T TypedTagValue(const TypedTag &tag, T def, std::true_type){
+      switch(tag.type){
+      case TAG_UINT:
+	return T(tag.value);
+      case TAG_INT:
+	return T(int64_t(tag.value));
+      case TAG_DOUBLE:{
+	double d;
+	std::memcpy(&d, &tag.value, sizeof(d));
+	return T(d);
+      }
+      default:
+	return def;
+      }
+    }
+    template <typename T>
+    static T TypedTagValue(const TypedTag &tag, T def, std::false_type){
+      return eudaq::from_string(FormatTypedTag(tag), def);
+    }
+
     template <typename T>
       static std::vector<uint8_t> make_vector(const T *data, size_t bytes) {
       const uint8_t *ptr = reinterpret_cast<const uint8_t *>(data);
@@ -176,6 +244,7 @@ namespace eudaq {
     uint64_t m_ts_end;
     std::string m_dspt;
     std::map<std::string, std::string> m_tags;
+    std::vector<TypedTag> m_typed_tags;
     std::map<uint32_t, std::vector<uint8_t>> m_blocks;
     std::vector<EventSPC> m_sub_events;
   };
@@ -0,0 +1,59 @@
+#ifndef EUDAQ_INCLUDED_EventSelection
+#define EUDAQ_INCLUDED_EventSelection
+
+#include "eudaq/Event.hh"
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <set>
+#include <cstdint>
+
+namespace eudaq {
+
+  /**
+   * The events a DataReceiver wants to get from its DataSenders.
+   * It is sent back in the reply to the connection handshake, so that the
+   * sender can drop unwanted events before they are serialized.
+   * An event is selected if its type or the type of one of its sub-events
+   * is in the type list, it has all flag bits of the flag mask set, and the
+   * event or one of its sub-events has the requested device description.
+   * Of the selected events, one out of GetSampling() is sent. BORE and EORE
+   * are always sent. With adaptive sampling, the receiver reports how fast
+   * it consumes events and the sender raises the sampling factor while the
+   * receiver falls behind.
+   */
+  class DLLEXPORT EventSelection {
+  public:
+    EventSelection();
+    static EventSelection FromString(const std::string &str);
+    std::string ToString() const;
+    /// True if every event is sent, i.e. there is nothing to select
+    bool IsEmpty() const;
+    /// Type, flag and device cuts, the sampling is done by the sender
+    bool Match(const Event &ev) const;
+    void SetSampling(uint32_t n);
+    uint32_t GetSampling() const;
+    void AddType(uint32_t type);
+    void ClearTypes();
+    const std::set<uint32_t>& GetTypes() const;
+    void SetFlagMask(uint32_t mask);
+    uint32_t GetFlagMask() const;
+    void SetDevice(const std::string &dspt);
+    std::string GetDevice() const;
+    void SetAdaptive(bool adaptive);
+    bool IsAdaptive() const;
+    bool operator==(const EventSelection &other) const;
+    bool operator!=(const EventSelection &other) const;
+
+  private:
+    bool MatchType(const Event &ev) const;
+    bool MatchDevice(const Event &ev) const;
+    uint32_t m_sampling;
+    std::set<uint32_t> m_types;
+    uint32_t m_flag_mask;
+    std::string m_device;
+    bool m_adaptive;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_EventSelection
@@ -0,0 +1,61 @@
+#ifndef EUDAQ_INCLUDED_EventSpillQueue
+#define EUDAQ_INCLUDED_EventSpillQueue
+
+#include "eudaq/Event.hh"
+#include "eudaq/FileSerializer.hh"
+#include "eudaq/FileDeserializer.hh"
+#include "eudaq/Platform.hh"
+
+#include <deque>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+namespace eudaq {
+  class EventSpillQueue;
+  using EventSpillQueueSP = std::shared_ptr<EventSpillQueue>;
+
+  /**
+   * A FIFO of events whose tail can be moved to a temporary file.
+   * Once events have been spilled, new events are appended to the file
+   * as well, so that the order is kept. The file is read back in chunks
+   * when the in-memory part runs empty, and removed when fully consumed.
+   * The queue is not thread safe, except for the byte counters.
+   */
+  class DLLEXPORT EventSpillQueue {
+  public:
+    EventSpillQueue(const std::string &name, const std::string &filename,
+		    uint64_t replay_bytes = 16*1024*1024);
+    ~EventSpillQueue();
+    void Push(EventSPC ev);
+    EventSPC Front();
+    void Pop();
+    bool Empty() const;
+    size_t Size() const;
+    void Clear();
+    /// Move all but the front event to disk, returns the number of bytes spilled
+    uint64_t Spill();
+    uint64_t GetMemoryBytes() const;
+    uint64_t GetSpilledBytes() const;
+    std::string GetName() const;
+    std::chrono::steady_clock::time_point GetLastPush() const;
+
+  private:
+    void WriteSpill(EventSPC ev);
+    void Replay();
+    void CloseSpill();
+    std::string m_name;
+    std::string m_filename;
+    uint64_t m_replay_bytes;
+    std::deque<std::pair<EventSPC, uint64_t>> m_que_mem;
+    std::deque<uint64_t> m_que_spill;
+    std::unique_ptr<FileSerializer> m_ser;
+    std::unique_ptr<FileDeserializer> m_des;
+    std::atomic<uint64_t> m_bytes_mem;
+    std::atomic<uint64_t> m_bytes_spill;
+    std::chrono::steady_clock::time_point m_tp_push;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_EventSpillQueue
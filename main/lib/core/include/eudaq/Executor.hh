@@ -0,0 +1,57 @@
+#ifndef EUDAQ_INCLUDED_Executor
+#define EUDAQ_INCLUDED_Executor
+
+#include "eudaq/Platform.hh"
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+namespace eudaq {
+
+  /**
+   * A fixed pool of threads running short tasks. Every worker has its own
+   * task queue; a task submitted from a worker goes to the queue of that
+   * worker, other tasks to a shared one. A worker without tasks of its own
+   * takes them from the shared queue or steals them from another worker,
+   * and sleeps when there are none, so an idle pool does not use any CPU.
+   * Tasks run in no particular order and must not wait for each other.
+   */
+  class DLLEXPORT Executor {
+  public:
+    explicit Executor(uint32_t n = 0);
+    ~Executor();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    void Submit(std::function<void()> task);
+    uint32_t GetThreadN() const;
+    /// True if called from a task of this Executor
+    bool IsWorkerThread() const;
+    /// The pool shared by all Processors, with one thread per core
+    static Executor& Instance();
+
+  private:
+    struct Worker {
+      std::mutex mtx;
+      std::deque<std::function<void()>> tasks;
+    };
+    void Run(uint32_t i);
+    bool TakeTask(uint32_t i, uint64_t n, std::function<void()> &task);
+    static bool TakeFrom(Worker &w, std::function<void()> &task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    Worker m_shared;
+    std::atomic<uint64_t> m_pending;
+    std::mutex m_mtx_sleep;
+    std::condition_variable m_cv_sleep;
+    bool m_stop;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_Executor
@@ -0,0 +1,52 @@
+#ifndef EUDAQ_INCLUDED_LatencyHistogram
+#define EUDAQ_INCLUDED_LatencyHistogram
+
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+namespace eudaq {
+
+  /**
+   * Histogram of latencies in nanoseconds with log-linear buckets, in the
+   * spirit of HdrHistogram: every power of two is split into 32 equal
+   * buckets, so any recorded value is known to about 3% from 1 ns up to
+   * hundreds of years. Record is lock-free and can be called from any
+   * thread.
+   */
+  class DLLEXPORT LatencyHistogram {
+  public:
+    LatencyHistogram();
+    void Record(uint64_t ns);
+    uint64_t GetCount() const;
+    uint64_t GetMax() const;
+    double GetMean() const;
+    /// Upper edge of the bucket holding the fraction q of the values
+    uint64_t GetQuantile(double q) const;
+    void Reset();
+    /// Set the status tags <prefix>N, <prefix>P50, <prefix>P99 and
+    /// <prefix>Max, in milliseconds, through the setter f
+    template <typename F> void ExportTags(const std::string &prefix, F f) const {
+      f(prefix + "N", std::to_string(GetCount()));
+      f(prefix + "P50", ToMs(GetQuantile(0.5)));
+      f(prefix + "P99", ToMs(GetQuantile(0.99)));
+      f(prefix + "Max", ToMs(GetMax()));
+    }
+
+    static uint32_t BucketIndex(uint64_t ns);
+    static uint64_t BucketUpper(uint32_t i);
+    static std::string ToMs(uint64_t ns);
+
+  private:
+    static const uint32_t SUB_BITS = 5;
+    static const uint32_t NUM_BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+    std::atomic<uint64_t> m_counts[NUM_BUCKETS];
+    std::atomic<uint64_t> m_total;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_LatencyHistogram
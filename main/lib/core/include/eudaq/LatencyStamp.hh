@@ -0,0 +1,42 @@
+#ifndef EUDAQ_INCLUDED_LatencyStamp
+#define EUDAQ_INCLUDED_LatencyStamp
+
+#include "eudaq/Event.hh"
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <cstdint>
+
+namespace eudaq {
+
+  /**
+   * Wall-clock stamps, in nanoseconds since the epoch, that an event collects
+   * as event tags on its way from the producer to the monitors. Comparing
+   * stamps taken on different hosts is only as good as their clock
+   * synchronisation.
+   */
+  class DLLEXPORT LatencyStamp {
+  public:
+    enum Hop {
+      PRODUCER_SEND,
+      COLLECTOR_RECEIVE,
+      COLLECTOR_WRITE,
+      MONITOR_RECEIVE,
+      NUM_HOPS
+    };
+    static uint64_t Now();
+    static std::string TagName(Hop hop);
+    static void Stamp(Event &ev, Hop hop, uint64_t ns = Now());
+    /// Stamp of the event itself or, failing that, the earliest one of its
+    /// sub-events, 0 if there is none
+    static uint64_t Get(const Event &ev, Hop hop);
+    /// Time from hop from to hop to, false if a stamp is missing or the
+    /// clocks disagree on the order
+    static bool GetInterval(const Event &ev, Hop from, Hop to, uint64_t &ns);
+    /// Copy the earliest sub-event stamps of the hops before hop to the
+    /// event, so that a built event carries the stamps of its parts
+    static void Propagate(Event &ev, Hop hop);
+  };
+}
+
+#endif // EUDAQ_INCLUDED_LatencyStamp
@@ -6,11 +6,23 @@
 #include "eudaq/Status.hh"
 #include "Platform.hh"
 #include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <chrono>
 
 namespace eudaq {
 
   class LogMessage;
 
+  /// Messages are put into a lock-free ring and printed and sent to the
+  /// LogCollector by a background thread, so logging never waits for the
+  /// console or the network. When the ring is full the message is dropped.
+  /// The sender thread collapses repeats of the same message and limits the
+  /// rate of messages below LVL_ERROR; dropped messages are counted and
+  /// reported.
   class DLLEXPORT LogSender {
   public:
     LogSender();
@@ -19,8 +31,16 @@ namespace eudaq {
                  const std::string &server);
     void Disconnect();
     void SendLogMessage(const LogMessage &);
+    /// Print to the given streams on the calling thread, the message is
+    /// still sent to the LogCollector in the background
     void SendLogMessage(const LogMessage &msg, std::ostream &out,
                         std::ostream &error_out);
+    /// Wait until all queued messages have been handled
+    void Flush();
+    /// Messages per second and burst size, 0 disables the limit
+    void SetRateLimit(double per_second, uint32_t burst);
+    /// Messages lost because the ring was full or the rate was exceeded
+    uint64_t GetDroppedN() const { return m_drop_full + m_drop_rate; }
     void SetLevel(int level) { m_level = level; }
     void SetLevel(const std::string &level) {
       SetLevel(Status::String2Level(level));
@@ -34,6 +54,15 @@ namespace eudaq {
     }
 
   private:
+    struct Slot;
+    void StartSender();
+    bool Push(const LogMessage &msg, bool console);
+    void SenderLoop();
+    void Handle(LogMessage &msg, bool console);
+    void Emit(const LogMessage &msg, bool console);
+    void FlushRepeats();
+    void ReportDropped();
+
     std::string m_name;
     TransportClient *m_logclient;
     int m_level;
@@ -41,6 +70,35 @@ namespace eudaq {
     bool m_shownotconnected;
     bool isConnected = false;
     std::recursive_mutex m_mutex;
+
+    // ring written by any thread, read by the sender thread only
+    std::unique_ptr<Slot[]> m_ring;
+    size_t m_ring_mask;
+    std::atomic<uint64_t> m_head;
+    uint64_t m_tail;
+    std::atomic<uint64_t> m_done;
+    std::once_flag m_start;
+    std::thread m_thread;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_sleeping;
+    std::mutex m_mtx_wake;
+    std::condition_variable m_cv_wake;
+    std::condition_variable m_cv_done;
+    std::atomic<double> m_rate;
+    std::atomic<double> m_burst;
+
+    // used by the sender thread only
+    std::unique_ptr<LogMessage> m_last;
+    bool m_last_console;
+    bool m_last_dropped;
+    uint64_t m_repeat;
+    std::chrono::steady_clock::time_point m_last_emit;
+    double m_tokens;
+    std::chrono::steady_clock::time_point m_refill;
+    std::chrono::steady_clock::time_point m_last_report;
+    std::atomic<uint64_t> m_drop_full;
+    std::atomic<uint64_t> m_drop_rate;
+    uint64_t m_drop_reported;
   };
 }
 
@@ -0,0 +1,48 @@
+#ifndef EUDAQ_INCLUDED_ParallelProcessor
+#define EUDAQ_INCLUDED_ParallelProcessor
+
+#include "eudaq/Processor.hh"
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace eudaq {
+
+  /**
+   * Runs the batches it receives on a number of replicas of a processor at
+   * the same time and forwards their output in the order of the input.
+   * Every replica handles its own batches one after the other, so replicas
+   * may keep state. Register it as "ParallelProcessor" and add the replicas
+   * with AddReplica before sending events.
+   */
+  class DLLEXPORT ParallelProcessor: public Processor {
+  public:
+    ParallelProcessor();
+    void AddReplica(ProcessorSP ps);
+    size_t GetReplicaN() const;
+    void ProcessEvents(const EventBatch& evs) override;
+    bool IsIdle() override;
+
+  private:
+    struct Replica {
+      ProcessorSP ps;
+      std::mutex mtx;
+      std::deque<std::pair<uint64_t, EventBatch>> que;
+      bool scheduled = false;
+    };
+    void RunReplica(Replica *r);
+    void Complete(uint64_t seq, std::vector<EventBatch> &&out);
+
+    std::vector<std::unique_ptr<Replica>> m_replicas;
+    uint64_t m_seq_in;
+    std::mutex m_mtx_merge;
+    uint64_t m_seq_out;
+    std::map<uint64_t, std::vector<EventBatch>> m_done;
+    std::atomic<uint64_t> m_inflight;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_ParallelProcessor
@@ -13,6 +13,8 @@
 
 #include "Event.hh"
 #include "Factory.hh"
+#include "Exception.hh"
+#include "Executor.hh"
 
 namespace eudaq {
   class Processor;
@@ -27,6 +29,34 @@ namespace eudaq {
   using ProcessorUP = Factory<Processor>::UP_BASE;
   using ProcessorSP = Factory<Processor>::SP_BASE;
   using ProcessorWP = Factory<Processor>::WP_BASE;
+
+  /// Events of the same event id, handed from processor to processor
+  /// together so that the locking and routing is done once for all of them
+  class EventBatch {
+  public:
+    EventBatch():m_id(0){}
+    explicit EventBatch(EventSPC ev):m_id(ev->GetEventID()), m_evs(1, ev){}
+    uint32_t GetEventID() const {return m_id;}
+    /// True if ev can be added, i.e. the batch is empty or has its id
+    bool Accepts(const EventSPC &ev) const {return m_evs.empty() || ev->GetEventID() == m_id;}
+    void push_back(EventSPC ev){
+      if(!Accepts(ev))
+	EUDAQ_THROW("EventBatch: event id "+std::to_string(ev->GetEventID())+" added to a batch of "+std::to_string(m_id));
+      if(m_evs.empty())
+	m_id = ev->GetEventID();
+      m_evs.push_back(std::move(ev));
+    }
+    void reserve(size_t n){m_evs.reserve(n);}
+    void clear(){m_evs.clear();}
+    size_t size() const {return m_evs.size();}
+    bool empty() const {return m_evs.empty();}
+    const EventSPC& operator[](size_t i) const {return m_evs[i];}
+    std::vector<EventSPC>::const_iterator begin() const {return m_evs.begin();}
+    std::vector<EventSPC>::const_iterator end() const {return m_evs.end();}
+  private:
+    uint32_t m_id;
+    std::vector<EventSPC> m_evs;
+  };
   
   class DLLEXPORT Processor: public std::enable_shared_from_this<Processor>{
   public:
@@ -39,18 +69,35 @@ namespace eudaq {
     Processor() = delete;
     virtual ~Processor();
     virtual void ProcessEvent(EventSPC ev);
+    /// Calls ProcessEvent for each event, override to handle them together.
+    /// Events forwarded meanwhile are sent on as a batch at the end.
+    virtual void ProcessEvents(const EventBatch& evs);
     virtual void ProduceEvent(){};
     virtual void ProcessCommand(const std::string& cmd, const std::string& arg){};
 
     void ForwardEvent(EventSPC ev);
+    void ForwardEvents(const EventBatch& evs);
     void RegisterEvent(EventSPC ev);
+    void RegisterEvents(const EventBatch& evs);
+    /// Call ProcessEvents right here, keeping what it forwards in out
+    /// instead of sending it downstream
+    void ProcessInto(const EventBatch& evs, std::vector<EventBatch>& out);
+    /// Nothing queued or being processed by this processor
+    virtual bool IsIdle();
+    /// Number of times events have been registered to this processor
+    inline uint64_t GetRegisteredN() const {return m_reg_c;};
 
     void StopProducer();
+    void WaitProducer();
     inline bool GetProducerStopFlag() const {return m_pdc_go_stop;};
     inline uint32_t GetInstanceN()const {return m_instance_n;};
     inline std::string GetDescription()const {return m_description;};
     void Print(std::ostream &os, uint32_t offset=0) const;
     
+    /// Send the events of the ids in evset, or of the default ones if it
+    /// is empty, to ps
+    void RegisterDownstream(ProcessorSP ps, const std::set<uint32_t>& evset = {});
+
     ProcessorSP operator>>(ProcessorSP psr);
     ProcessorSP operator<<(const std::string& cmd);
 
@@ -59,12 +106,16 @@ namespace eudaq {
     ProcessorSP operator<<=(EventSPC ev);
 
   private:
-    void Processing(EventSPC ev);
+    void Processing(const EventBatch& evs);
+    void ProcessBatch(const EventBatch& evs, std::vector<EventBatch>* capture = nullptr);
+    void WaitHubSpace(std::unique_lock<std::mutex>& lk);
     void ConsumeEvent();
     void HubProcessing(); //relay
+    void StopHub();
+    void StopConsumer();
     void ProcessSysCommand(const std::string& cmd, const std::string& arg);
     void RegisterProcessing(ProcessorSP ps, EventSPC ev);
-    void RegisterDownstream(ProcessorSP ps, const std::set<uint32_t>& evset = {});
+    void RegisterProcessing(ProcessorSP ps, const EventBatch& evs);
     void RegisterUpstream(ProcessorSP up, ProcessorWP hub);
     
   private:
@@ -80,14 +131,19 @@ namespace eudaq {
     
     std::atomic_bool m_hub_force;
     
+    // the hub and consumer queues are drained by one Executor task at a
+    // time, which keeps the order of the events
     std::deque<EventSPC> m_que_csm;
     std::deque<std::pair<ProcessorSP, EventSPC> > m_que_hub;
     std::mutex m_mtx_csm;
     std::mutex m_mtx_hub;
-    std::condition_variable m_cv_csm;
+    std::condition_variable m_cv_csm; // a queue has been drained
     std::condition_variable m_cv_hub;
-    std::thread m_th_csm;
-    std::thread m_th_hub;
+    bool m_csm_on;
+    bool m_csm_scheduled;
+    bool m_hub_scheduled;
+    size_t m_que_max; // hub queue size producers wait at, 0 for no limit
+    std::atomic<uint64_t> m_reg_c;
     std::thread m_th_pdc;
     std::atomic_bool m_csm_go_stop;
     std::atomic_bool m_hub_go_stop;
@@ -0,0 +1,74 @@
+#ifndef EUDAQ_INCLUDED_ProcessorPipeline
+#define EUDAQ_INCLUDED_ProcessorPipeline
+
+#include "eudaq/Processor.hh"
+#include "eudaq/Configuration.hh"
+#include "eudaq/Platform.hh"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace eudaq {
+
+  /**
+   * A graph of processors built from a configuration:
+   *
+   *   [Pipeline]
+   *   PROCESSORS = reader, conv, writer
+   *
+   *   [Processor.reader]
+   *   TYPE = FileReaderProcessor
+   *   FILE = run000123.raw
+   *
+   *   [Processor.conv]
+   *   TYPE = StdEventConverterProcessor
+   *   INPUT = reader
+   *   EVENTS = StandardEvent
+   *   PARALLEL = 4
+   *
+   *   [Processor.writer]
+   *   TYPE = FileWriterProcessor
+   *   INPUT = conv
+   *   FILE = run000123_std.dat
+   *   FORMAT = native
+   *
+   * In the section of a processor, TYPE is its factory name and INPUT lists
+   * the processors it gets events from, by default those of the types in
+   * their EVENTS; INPUT_EVENTS chooses other types. EVENTS lists the event
+   * types it forwards, RawEvent if not given. PARALLEL = N runs N replicas
+   * of it at the same time and keeps the event order; the replicas must be
+   * free of side effects, so sources, file readers and writers and data
+   * receivers are refused. QUEUE_MAX bounds its queue for the sources,
+   * HUB = 1 gives it its own queue for all events of its inputs and
+   * CONSUMER = 1 one for its own processing. All other
+   * keys are handed to the processor with ProcessCommand, e.g. FILE and
+   * FORMAT of the file reader and writer.
+   * Processors without INPUT are the sources, their ProduceEvent is run by
+   * Start.
+   */
+  class DLLEXPORT ProcessorPipeline {
+  public:
+    explicit ProcessorPipeline(const Configuration &conf);
+    ~ProcessorPipeline();
+    void Start();
+    /// Wait for the sources to finish and their events to pass
+    void Wait();
+    /// Stop the sources and wait for the events on their way
+    void Stop();
+    ProcessorSP GetProcessor(const std::string &name) const;
+    void Print(std::ostream &os) const;
+
+  private:
+    ProcessorSP MakeProcessor(const Configuration &conf, const std::string &name);
+    uint64_t GetRegisteredN() const;
+    bool IsIdle() const;
+
+    std::vector<std::string> m_names;
+    std::map<std::string, ProcessorSP> m_ps;
+    std::vector<ProcessorSP> m_sources;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_ProcessorPipeline
@@ -57,6 +57,7 @@ namespace eudaq {
   private:
     uint32_t m_pdc_n;
     uint32_t m_evt_c;
+    bool m_stamp;
     std::mutex m_mtx_sender;
     std::map<std::string, std::shared_ptr<DataSender>> m_senders;
   };
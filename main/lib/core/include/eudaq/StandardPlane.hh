@@ -9,9 +9,51 @@
 
 #include <vector>
 #include <string>
+#include <algorithm>
 
 namespace eudaq {
 
+  /**
+   * Compact struct-of-arrays hit storage of a StandardPlane.
+   * All frames share one contiguous set of arrays, frame i spanning
+   * [FrameBegin(i), FrameEnd(i)). Coordinates are 16-bit integers and pixel
+   * values are signed integers of 1, 2 or 4 bytes, or absent (width 0) for
+   * binary sensors where every hit has the value 1. Timestamps and pivot bits
+   * are only stored when at least one hit uses them.
+   */
+  class DLLEXPORT CompactPlaneHits : public Serializable {
+  public:
+    CompactPlaneHits(uint8_t pix_bytes = 2);
+    CompactPlaneHits(Deserializer &);
+    void Serialize(Serializer &) const override;
+    void Clear();
+    void AddFrame();
+    void PushHit(uint16_t x, uint16_t y, int32_t pix = 1, uint64_t time_ps = 0,
+                 bool pivot = false);
+    bool CanStorePixel(double pix) const;
+
+    uint8_t PixelBytes() const;
+    uint32_t NumFrames() const;
+    uint32_t NumHits() const;
+    uint32_t FrameBegin(uint32_t frame) const;
+    uint32_t FrameEnd(uint32_t frame) const;
+    const std::vector<uint16_t> &XVector() const;
+    const std::vector<uint16_t> &YVector() const;
+    int32_t GetPixel(uint32_t index) const;
+    uint64_t GetTimestamp(uint32_t index) const;
+    bool GetPivot(uint32_t index) const;
+    bool HasTimestamps() const;
+    bool HasPivots() const;
+
+  private:
+    uint8_t m_pix_bytes;
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint16_t> m_x, m_y;
+    std::vector<uint8_t> m_pix;
+    std::vector<uint64_t> m_time;
+    std::vector<uint8_t> m_pivot;
+  };
+
   class DLLEXPORT StandardPlane : public Serializable {
   public:
     enum FLAGS {
@@ -21,7 +63,8 @@ namespace eudaq {
       FLAG_ACCUMULATE = 0x8, // Multiple frames should be accumulated for output
       FLAG_WITHPIVOT = 0x10000, // Include before/after pivot boolean per pixel
       FLAG_WITHSUBMAT = 0x20000, // Include Submatrix ID per pixel
-      FLAG_DIFFCOORDS = 0x40000 // Each frame can have different coordinates (in ZS mode)
+      FLAG_DIFFCOORDS = 0x40000, // Each frame can have different coordinates (in ZS mode)
+      FLAG_COMPACT = 0x80000 // Serialized as CompactPlaneHits
     };
     typedef double pixel_t;
     typedef double coord_t;
@@ -60,6 +103,29 @@ namespace eudaq {
       PushPixelHelper(x, y, (double)pix, 0, false, frame);
     }
 
+    // Bulk insertion from contiguous arrays of equal length. An empty pix
+    // means a value of 1 for every hit, empty time_ps and pivot mean 0/false.
+    template <typename TC, typename TP = pixel_t>
+      void AppendHits(uint32_t frame, const std::vector<TC> &x, const std::vector<TC> &y,
+                      const std::vector<TP> &pix = std::vector<TP>(),
+                      const std::vector<uint64_t> &time_ps = std::vector<uint64_t>(),
+                      const std::vector<uint8_t> &pivot = std::vector<uint8_t>()) {
+      size_t n = x.size();
+      if (y.size() != n || (pix.size() && pix.size() != n) ||
+          (time_ps.size() && time_ps.size() != n) || (pivot.size() && pivot.size() != n))
+        EUDAQ_THROW("Mismatched array lengths in AppendHits");
+      size_t offset = GrowFrame(frame, n);
+      std::copy(x.begin(), x.end(), m_x[frame].begin() + offset);
+      std::copy(y.begin(), y.end(), m_y[frame].begin() + offset);
+      std::copy(pix.begin(), pix.end(), m_pix[frame].begin() + offset);
+      std::copy(time_ps.begin(), time_ps.end(), m_time[frame].begin() + offset);
+      if (m_pivot.size())
+        std::copy(pivot.begin(), pivot.end(), m_pivot[frame].begin() + offset);
+    }
+    // Room for n more hits in a frame, so that PushPixel or AppendHits do
+    // not reallocate while a converter fills it
+    void Reserve(uint32_t frame, size_t n);
+
     void SetPixelHelper(uint32_t index, uint32_t x, uint32_t y, double pix, uint64_t time_ps,
                         bool pivot, uint32_t frame);
     void PushPixelHelper(uint32_t x, uint32_t y, double pix, uint64_t time_ps, bool pivot,
@@ -94,6 +160,17 @@ namespace eudaq {
     const std::vector<pixel_t> &PixVector(uint32_t frame) const;
     const std::vector<pixel_t> &PixVector() const;
 
+    // Lossless conversion to and from the compact layout, ToCompact returns
+    // false if the hits can not be represented (see CompactPlaneHits).
+    // The compact layout is only used on the wire, in memory a plane
+    // always keeps the per-frame vectors below.
+    bool ToCompact(CompactPlaneHits &hits) const;
+    void FromCompact(const CompactPlaneHits &hits);
+    // Serialize in the compact layout with pix_bytes wide pixel values,
+    // falls back to the plain layout whenever ToCompact fails.
+    // Call after SetSizeZS/SetSizeRaw, which reset the flags.
+    void SetCompact(uint8_t pix_bytes = 2);
+
     void SetXSize(uint32_t x);
     void SetYSize(uint32_t y);
     void SetPivotPixel(uint32_t p);
@@ -121,6 +198,7 @@ namespace eudaq {
     const std::vector<pixel_t> &
       GetFrame(const std::vector<std::vector<pixel_t>> &v, uint32_t f) const;
     void SetupResult() const;
+    size_t GrowFrame(uint32_t frame, size_t n);
 
     std::string m_type;
     std::string m_sensor;
@@ -129,6 +207,7 @@ namespace eudaq {
     uint32_t m_ysize;
     uint32_t m_flags;
     uint32_t m_pivotpixel;
+    uint8_t m_compact_pix_bytes{2};
 
     // Timestamp of this plane in picoseconds
     uint64_t m_timestamp{};
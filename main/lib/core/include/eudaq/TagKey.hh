@@ -0,0 +1,37 @@
+#ifndef EUDAQ_INCLUDED_TagKey
+#define EUDAQ_INCLUDED_TagKey
+
+#include "eudaq/Platform.hh"
+
+#include <string>
+#include <map>
+#include <cstdint>
+
+namespace eudaq {
+
+  /**
+   * Interned name of a typed event tag. The id is the hash of the name, so
+   * a tag can always be found by its name; the name itself only travels
+   * in the key table of BORE events, for the typed tags they carry. Two
+   * names with the same id are reported, and the first one is kept. Construct keys once, e.g. as static
+   * objects, and reuse them for every event.
+   */
+  class DLLEXPORT TagKey {
+  public:
+    explicit TagKey(const std::string &name);
+    uint32_t GetId() const { return m_id; }
+    const std::string &GetName() const { return m_name; }
+
+    /// Remember the name of an id, false if the id belongs to another name
+    static bool Register(uint32_t id, const std::string &name);
+    /// Name of a registered id, "0x" and the hex id if it is unknown
+    static std::string Name(uint32_t id);
+    static std::map<uint32_t, std::string> GetRegistered();
+
+  private:
+    uint32_t m_id;
+    std::string m_name;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_TagKey
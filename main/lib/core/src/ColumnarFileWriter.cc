@@ -0,0 +1,229 @@
+#include "eudaq/FileNamer.hh"
+#include "eudaq/FileWriter.hh"
+#include "eudaq/FileSerializer.hh"
+#include "eudaq/StandardEvent.hh"
+#include "eudaq/StdEventConverter.hh"
+
+#include <ctime>
+
+// Hit-level columnar export of StandardEvents. Three tables, each written
+// in row groups of whole columns:
+//   events: run, event, trigger, timestamp_begin, timestamp_end, planes
+//   planes: run, event, plane, x_size, y_size, hits
+//   hits:   run, event, trigger, plane, x, y, value, timestamp
+// Little-endian layout:
+//   file:      "EUDAQCOL" u32:version row_group* footer
+//   row_group: str:table u64:rows u32:columns column*
+//   column:    str:name u8:type(1 u32, 2 u64, 3 f64) u64:bytes data
+//   footer:    u32:groups (str:table u64:offset u64:rows)*
+//              u64:footer_offset "EUDAQCOL"
+//   str:       u32:length chars
+// A file without footer (e.g. after a crash) can still be read group by
+// group from the start.
+class ColumnarFileWriter : public eudaq::FileWriter {
+public:
+  ColumnarFileWriter(const std::string &patt);
+  ~ColumnarFileWriter() override;
+  void WriteEvent(eudaq::EventSPC ev) override;
+  uint64_t FileBytes() const override;
+private:
+  struct GroupIndex {
+    std::string table;
+    uint64_t offset;
+    uint64_t rows;
+  };
+  void Open(uint32_t run_n);
+  void Close();
+  void WriteRowGroups();
+  void Fill(const eudaq::Event &ev, const eudaq::StandardEvent *stdev);
+
+  std::unique_ptr<eudaq::FileSerializer> m_ser;
+  std::string m_filepattern;
+  uint32_t m_run_n;
+  size_t m_row_group;
+  std::vector<GroupIndex> m_index;
+
+  std::vector<uint32_t> m_ev_run, m_ev_event, m_ev_trigger, m_ev_planes;
+  std::vector<uint64_t> m_ev_ts_begin, m_ev_ts_end;
+  std::vector<uint32_t> m_pl_run, m_pl_event, m_pl_plane, m_pl_xsize, m_pl_ysize, m_pl_hits;
+  std::vector<uint32_t> m_hit_run, m_hit_event, m_hit_trigger, m_hit_plane;
+  std::vector<double> m_hit_x, m_hit_y, m_hit_value;
+  std::vector<uint64_t> m_hit_ts;
+};
+
+namespace{
+  auto dummy0 = eudaq::Factory<eudaq::FileWriter>::
+    Register<ColumnarFileWriter, std::string&>(eudaq::cstr2hash("columnar"));
+  auto dummy1 = eudaq::Factory<eudaq::FileWriter>::
+    Register<ColumnarFileWriter, std::string&&>(eudaq::cstr2hash("columnar"));
+
+  const char MAGIC[] = "EUDAQCOL";
+  const uint32_t FORMAT_VERSION = 1;
+
+  uint8_t ColumnType(const std::vector<uint32_t> &){return 1;}
+  uint8_t ColumnType(const std::vector<uint64_t> &){return 2;}
+  uint8_t ColumnType(const std::vector<double> &){return 3;}
+
+  template <typename T>
+  void WriteColumn(eudaq::Serializer &ser, const std::string &name, std::vector<T> &col){
+    uint64_t bytes = col.size() * sizeof(T);
+    ser.write(name);
+    ser.write(ColumnType(col));
+    ser.write(bytes);
+    ser.append(reinterpret_cast<const uint8_t*>(col.data()), bytes);
+    col.clear();
+  }
+}
+
+ColumnarFileWriter::ColumnarFileWriter(const std::string &patt)
+  :m_filepattern(patt), m_run_n(0), m_row_group(1 << 16){
+}
+
+ColumnarFileWriter::~ColumnarFileWriter(){
+  try{
+    Close();
+  }
+  catch(const std::exception &e){
+    std::cerr << "ColumnarFileWriter: " << e.what() << std::endl;
+  }
+}
+
+void ColumnarFileWriter::Open(uint32_t run_n){
+  Close();
+  auto conf = GetConfiguration();
+  if(conf)
+    m_row_group = conf->Get("EUDAQ_FW_ROW_GROUP", m_row_group);
+  if(!m_row_group)
+    m_row_group = 1;
+  std::time_t time_now = std::time(nullptr);
+  char time_buff[13];
+  time_buff[12] = 0;
+  std::strftime(time_buff, sizeof(time_buff),
+		"%y%m%d%H%M%S", std::localtime(&time_now));
+  std::string time_str(time_buff);
+  m_ser.reset(new eudaq::FileSerializer((eudaq::FileNamer(m_filepattern).
+					 Set('X', ".col").
+					 Set('R', run_n).
+					 Set('D', time_str))));
+  m_ser->append(reinterpret_cast<const uint8_t*>(MAGIC), 8);
+  m_ser->write(FORMAT_VERSION);
+  m_run_n = run_n;
+}
+
+void ColumnarFileWriter::Close(){
+  if(!m_ser)
+    return;
+  WriteRowGroups();
+  uint64_t footer = m_ser->FileBytes();
+  m_ser->write((uint32_t)m_index.size());
+  for(auto &group: m_index){
+    m_ser->write(group.table);
+    m_ser->write(group.offset);
+    m_ser->write(group.rows);
+  }
+  m_ser->write(footer);
+  m_ser->append(reinterpret_cast<const uint8_t*>(MAGIC), 8);
+  m_ser->Flush();
+  m_ser.reset();
+  m_index.clear();
+}
+
+void ColumnarFileWriter::WriteRowGroups(){
+  eudaq::FileSerializer &ser = *m_ser;
+  if(!m_ev_run.empty()){
+    m_index.push_back(GroupIndex{"events", ser.FileBytes(), m_ev_run.size()});
+    ser.write(std::string("events"));
+    ser.write((uint64_t)m_ev_run.size());
+    ser.write((uint32_t)6);
+    WriteColumn(ser, "run", m_ev_run);
+    WriteColumn(ser, "event", m_ev_event);
+    WriteColumn(ser, "trigger", m_ev_trigger);
+    WriteColumn(ser, "timestamp_begin", m_ev_ts_begin);
+    WriteColumn(ser, "timestamp_end", m_ev_ts_end);
+    WriteColumn(ser, "planes", m_ev_planes);
+  }
+  if(!m_pl_run.empty()){
+    m_index.push_back(GroupIndex{"planes", ser.FileBytes(), m_pl_run.size()});
+    ser.write(std::string("planes"));
+    ser.write((uint64_t)m_pl_run.size());
+    ser.write((uint32_t)6);
+    WriteColumn(ser, "run", m_pl_run);
+    WriteColumn(ser, "event", m_pl_event);
+    WriteColumn(ser, "plane", m_pl_plane);
+    WriteColumn(ser, "x_size", m_pl_xsize);
+    WriteColumn(ser, "y_size", m_pl_ysize);
+    WriteColumn(ser, "hits", m_pl_hits);
+  }
+  if(!m_hit_run.empty()){
+    m_index.push_back(GroupIndex{"hits", ser.FileBytes(), m_hit_run.size()});
+    ser.write(std::string("hits"));
+    ser.write((uint64_t)m_hit_run.size());
+    ser.write((uint32_t)8);
+    WriteColumn(ser, "run", m_hit_run);
+    WriteColumn(ser, "event", m_hit_event);
+    WriteColumn(ser, "trigger", m_hit_trigger);
+    WriteColumn(ser, "plane", m_hit_plane);
+    WriteColumn(ser, "x", m_hit_x);
+    WriteColumn(ser, "y", m_hit_y);
+    WriteColumn(ser, "value", m_hit_value);
+    WriteColumn(ser, "timestamp", m_hit_ts);
+  }
+  ser.Flush();
+}
+
+void ColumnarFileWriter::Fill(const eudaq::Event &ev, const eudaq::StandardEvent *stdev){
+  uint32_t run_n = ev.GetRunN();
+  uint32_t ev_n = ev.GetEventN();
+  uint32_t tg_n = ev.GetTriggerN();
+  size_t nplanes = stdev ? stdev->NumPlanes() : 0;
+  m_ev_run.push_back(run_n);
+  m_ev_event.push_back(ev_n);
+  m_ev_trigger.push_back(tg_n);
+  m_ev_ts_begin.push_back(ev.GetTimestampBegin());
+  m_ev_ts_end.push_back(ev.GetTimestampEnd());
+  m_ev_planes.push_back(nplanes);
+  for(size_t i = 0; i < nplanes; i++){
+    auto &plane = stdev->GetPlane(i);
+    auto &x = plane.XVector();
+    auto &y = plane.YVector();
+    auto &pix = plane.PixVector();
+    size_t nhits = x.size();
+    m_pl_run.push_back(run_n);
+    m_pl_event.push_back(ev_n);
+    m_pl_plane.push_back(plane.ID());
+    m_pl_xsize.push_back(plane.XSize());
+    m_pl_ysize.push_back(plane.YSize());
+    m_pl_hits.push_back(nhits);
+    m_hit_run.insert(m_hit_run.end(), nhits, run_n);
+    m_hit_event.insert(m_hit_event.end(), nhits, ev_n);
+    m_hit_trigger.insert(m_hit_trigger.end(), nhits, tg_n);
+    m_hit_plane.insert(m_hit_plane.end(), nhits, plane.ID());
+    m_hit_x.insert(m_hit_x.end(), x.begin(), x.end());
+    m_hit_y.insert(m_hit_y.end(), y.begin(), y.end());
+    m_hit_value.insert(m_hit_value.end(), pix.begin(), pix.end());
+    for(size_t n = 0; n < nhits; n++)
+      m_hit_ts.push_back(plane.GetTimestamp(n));
+  }
+}
+
+void ColumnarFileWriter::WriteEvent(eudaq::EventSPC ev){
+  uint32_t run_n = ev->GetRunN();
+  if(!m_ser || m_run_n != run_n)
+    Open(run_n);
+  auto stdev = std::dynamic_pointer_cast<const eudaq::StandardEvent>(ev);
+  if(stdev)
+    Fill(*ev, stdev.get());
+  else{
+    auto conv = eudaq::StandardEvent::MakeShared();
+    if(eudaq::StdEventConverter::Convert(ev, conv, GetConfiguration()))
+      Fill(*ev, conv.get());
+    else
+      Fill(*ev, nullptr);
+  }
+  if(m_ev_run.size() >= m_row_group || m_hit_run.size() >= m_row_group)
+    WriteRowGroups();
+}
+
+uint64_t ColumnarFileWriter::FileBytes() const {
+  return m_ser ? m_ser->FileBytes() : 0;
+}
@@ -1,10 +1,13 @@
 #include "eudaq/DataCollector.hh"
 #include "eudaq/Logger.hh"
 #include "eudaq/Utils.hh"
+#include "eudaq/LatencyStamp.hh"
 #include <iostream>
 #include <ostream>
 #include <ctime>
 #include <iomanip>
+#include <cstdlib>
+#include <algorithm>
 namespace eudaq {
   template class DLLEXPORT Factory<DataCollector>;
   template DLLEXPORT std::map<uint32_t, typename Factory<DataCollector>::UP_BASE (*)
@@ -16,6 +19,10 @@ namespace eudaq {
     m_dct_n= str2hash(GetFullName());
     m_evt_c = 0;
     m_fraction = 1;
+    m_queue_c = 0;
+    m_mem_limit = 0;
+    m_stall_timeout = 0;
+    m_stamp = false;
   }
 
   DataCollector::~DataCollector(){  
@@ -81,6 +88,12 @@ namespace eudaq {
       m_fwpatt = conf->Get("EUDAQ_FW_PATTERN", "$12D_run$6R$X");
       m_dct_n = conf->Get("EUDAQ_ID", m_dct_n);
       m_fraction = conf->Get("EUDAQ_DATACOL_SEND_MONITOR_FRACTION", 10);
+      m_mem_limit = conf->Get("EUDAQ_DATACOL_MEMORY_LIMIT_MB", 2048);
+      m_mem_limit *= 1024*1024;
+      m_stall_timeout = conf->Get("EUDAQ_DATACOL_STALL_TIMEOUT", 0);
+      const char *tmpdir = std::getenv("TMPDIR");
+      m_spill_path = conf->Get("EUDAQ_DATACOL_SPILL_PATH", tmpdir?tmpdir:".");
+      m_stamp = conf->Get("EUDAQ_LATENCY_STAMPS", 0) != 0;
       DoConfigure();
       CommandReceiver::OnConfigure();
     }catch (const Exception &e) {
@@ -97,6 +110,8 @@ namespace eudaq {
       SetStatusTag("_SERVER", m_data_addr);
       m_writer = Factory<FileWriter>::Create<std::string&>(str2hash(m_fwtype), m_fwpatt);
       m_evt_c = 0;
+      m_lat_receive.Reset();
+      m_lat_write.Reset();
 
       std::string mn_str = GetConfiguration()->Get("EUDAQ_MN", "");
       std::vector<std::string> col_mn_name = split(mn_str, ";,", true);
@@ -165,6 +180,23 @@ namespace eudaq {
   void DataCollector::OnStatus(){
     SetStatusTag("EventN", std::to_string(m_evt_c));
     SetStatusTag("MonitorEventN", std::to_string(float(m_evt_c/m_fraction)));
+    std::unique_lock<std::mutex> lk(m_mtx_queue);
+    if(!m_queues.empty()){
+      uint64_t bytes_mem = 0;
+      uint64_t bytes_spill = 0;
+      for(auto &que: m_queues){
+	bytes_mem += que->GetMemoryBytes();
+	bytes_spill += que->GetSpilledBytes();
+      }
+      SetStatusTag("BufferedBytes", std::to_string(bytes_mem));
+      SetStatusTag("SpilledBytes", std::to_string(bytes_spill));
+      SetStatusTag("StalledStream", m_stalled);
+    }
+    lk.unlock();
+    if(m_lat_receive.GetCount())
+      m_lat_receive.ExportTags("ReceiveLatency", [this](const std::string &k, const std::string &v){SetStatusTag(k, v);});
+    if(m_lat_write.GetCount())
+      m_lat_write.ExportTags("WriteLatency", [this](const std::string &k, const std::string &v){SetStatusTag(k, v);});
     DoStatus();
     // if(m_writer && m_writer->FileBytes()){
     //   SetStatusTag("FILEBYTES", std::to_string(m_writer->FileBytes()));
@@ -180,6 +212,12 @@ namespace eudaq {
   }
     
   void DataCollector::OnReceive(ConnectionSPC id, EventSP ev){
+    if(m_stamp){
+      uint64_t ns;
+      LatencyStamp::Stamp(*ev, LatencyStamp::COLLECTOR_RECEIVE);
+      if(LatencyStamp::GetInterval(*ev, LatencyStamp::PRODUCER_SEND, LatencyStamp::COLLECTOR_RECEIVE, ns))
+	m_lat_receive.Record(ns);
+    }
     DoReceive(id, ev);
   }  
     
@@ -201,6 +239,13 @@ namespace eudaq {
 	file_writer->WriteEvent(ev);
       else
 	EUDAQ_THROW("FileWriter is not created before writing.");
+      if(m_stamp){
+	uint64_t ns;
+	LatencyStamp::Propagate(*ev, LatencyStamp::COLLECTOR_WRITE);
+	LatencyStamp::Stamp(*ev, LatencyStamp::COLLECTOR_WRITE);
+	if(LatencyStamp::GetInterval(*ev, LatencyStamp::COLLECTOR_RECEIVE, LatencyStamp::COLLECTOR_WRITE, ns))
+	  m_lat_write.Record(ns);
+      }
       std::unique_lock<std::mutex> lk(m_mtx_sender);
       auto senders = m_senders;
       lk.unlock();
@@ -221,6 +266,60 @@ namespace eudaq {
     }
   }
 
+  EventSpillQueueSP DataCollector::CreateEventQueue(const std::string &stream){
+    std::unique_lock<std::mutex> lk(m_mtx_queue);
+    std::string filename = m_spill_path + "/eudaq_spill_" + to_hex(m_dct_n, 8)
+      + "_" + std::to_string(m_queue_c++) + ".raw";
+    auto que = std::make_shared<EventSpillQueue>(stream, filename);
+    m_queues.push_back(que);
+    return que;
+  }
+
+  void DataCollector::RemoveEventQueue(EventSpillQueueSP que){
+    std::unique_lock<std::mutex> lk(m_mtx_queue);
+    m_queues.erase(std::remove(m_queues.begin(), m_queues.end(), que),
+		   m_queues.end());
+  }
+
+  void DataCollector::BalanceEventQueues(){
+    std::unique_lock<std::mutex> lk(m_mtx_queue);
+    std::string stalled;
+    bool pending = false;
+    uint64_t bytes_mem = 0;
+    for(auto &que: m_queues){
+      if(que->Empty())
+	stalled += (stalled.empty()?"":",") + que->GetName();
+      else
+	pending = true;
+      bytes_mem += que->GetMemoryBytes();
+    }
+    m_stalled = pending ? stalled : "";
+    if(!m_mem_limit || bytes_mem <= m_mem_limit)
+      return;
+    std::vector<EventSpillQueueSP> queues(m_queues);
+    std::sort(queues.begin(), queues.end(),
+	      [](const EventSpillQueueSP &a, const EventSpillQueueSP &b){
+		return a->GetMemoryBytes() > b->GetMemoryBytes();});
+    uint64_t bytes_spill = 0;
+    for(auto &que: queues){
+      if(bytes_mem <= m_mem_limit)
+	break;
+      uint64_t bytes_before = que->GetMemoryBytes();
+      bytes_spill += que->Spill();
+      bytes_mem -= bytes_before - que->GetMemoryBytes();
+    }
+    if(bytes_spill)
+      EUDAQ_WARN("DataCollector: memory limit exceeded, stalled stream(s) <"+m_stalled+">, "
+		 +std::to_string(bytes_spill)+" bytes spilled to "+m_spill_path);
+  }
+
+  bool DataCollector::IsEventQueueTimedOut(EventSpillQueueSP que) const{
+    if(!m_stall_timeout || !que->Empty())
+      return false;
+    auto tp_now = std::chrono::steady_clock::now();
+    return tp_now - que->GetLastPush() > std::chrono::seconds(m_stall_timeout);
+  }
+
   DataCollectorSP DataCollector::Make(const std::string &code_name,
 				      const std::string &run_name,
 				      const std::string &runcontrol){
@@ -10,7 +10,8 @@
 namespace eudaq {
   
   DataReceiver::DataReceiver()
-    :m_is_listening(false),m_is_destructing(false), m_last_addr("tcp://0"){
+    :m_is_listening(false),m_is_destructing(false), m_last_addr("tcp://0"),
+     m_sel_changed(false), m_consumed_c(0), m_consumed_last(0){
   }
 
   DataReceiver::~DataReceiver(){
@@ -83,7 +84,14 @@ namespace eudaq {
           part = std::string(ev.packet, i0, i1 - i0);
           con->SetName(part);
         } while (false);
-        m_dataserver->SendPacket("OK", *con, true);
+	{
+	  // tell the sender which events to send, before it sends any
+	  std::unique_lock<std::mutex> lk_sel(m_mx_sel);
+	  if(m_sel.IsEmpty())
+	    m_dataserver->SendPacket("OK", *con, true);
+	  else
+	    m_dataserver->SendPacket("OK " + m_sel.ToString(), *con, true);
+	}
         con->SetState(1); // successfully identified
 	EUDAQ_INFO("DataReceiver: Connection from " + to_string(*con));
 	m_vt_con.push_back(con);
@@ -113,8 +121,11 @@ namespace eudaq {
 
   bool DataReceiver::AsyncReceiving(){
     m_is_async_rcv_return = false;
+    m_tp_feedback = std::chrono::steady_clock::now();
+    m_consumed_last = m_consumed_c;
     while (m_is_listening){
       m_dataserver->Process(100000);
+      SendFeedback();
     }
     m_is_async_rcv_return = true;
     return 0;
@@ -141,6 +152,7 @@ namespace eudaq {
       lk.unlock();
       if(ev){
 	OnReceive(con, ev);
+	m_consumed_c ++;
       }
       else{
 	if(con->GetState())
@@ -159,6 +171,47 @@ namespace eudaq {
     return 0;
   }
   
+  void DataReceiver::SetEventSelection(const EventSelection &sel){
+    std::unique_lock<std::mutex> lk(m_mx_sel);
+    if(sel == m_sel)
+      return;
+    m_sel = sel;
+    m_sel_changed = true;
+  }
+
+  EventSelection DataReceiver::GetEventSelection() const{
+    std::unique_lock<std::mutex> lk(m_mx_sel);
+    return m_sel;
+  }
+
+  void DataReceiver::SendFeedback(){
+    // called from the receiving thread only, which owns the connections
+    std::unique_lock<std::mutex> lk_sel(m_mx_sel);
+    EventSelection sel = m_sel;
+    bool changed = m_sel_changed.exchange(false);
+    lk_sel.unlock();
+    if(changed){
+      for(auto &con: m_vt_con)
+	m_dataserver->SendPacket("SELECT " + sel.ToString(), *con);
+    }
+    if(!sel.IsAdaptive())
+      return;
+    auto tp_now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(tp_now - m_tp_feedback).count();
+    if(dt < 1 || m_vt_con.empty())
+      return;
+    m_tp_feedback = tp_now;
+    uint64_t consumed_c = m_consumed_c;
+    double rate = (consumed_c - m_consumed_last) / dt / m_vt_con.size();
+    m_consumed_last = consumed_c;
+    std::unique_lock<std::mutex> lk(m_mx_qu_ev);
+    uint64_t backlog = m_qu_ev.size();
+    lk.unlock();
+    for(auto &con: m_vt_con)
+      m_dataserver->SendPacket("RATE " + std::to_string(rate) + " "
+			       + std::to_string(backlog), *con);
+  }
+
   std::string DataReceiver::Listen(const std::string &addr){
     std::unique_lock<std::mutex> lk_deamon(m_mx_deamon);
     if(!m_fut_deamon.valid())
@@ -0,0 +1,46 @@
+#include "eudaq/Processor.hh"
+#include "eudaq/DataReceiver.hh"
+#include "eudaq/Logger.hh"
+
+#include <chrono>
+
+namespace eudaq {
+
+  /// Source forwarding the events sent to the address LISTEN, e.g. by a
+  /// DataCollector that has it as one of its monitors
+  class DataReceiverProcessor: public Processor, public DataReceiver {
+  public:
+    DataReceiverProcessor();
+    void ProduceEvent() override;
+    void ProcessCommand(const std::string& cmd, const std::string& arg) override;
+    void OnReceive(ConnectionSPC id, EventSP ev) override;
+    static const uint32_t m_id_factory = cstr2hash("DataReceiverProcessor");
+  private:
+    std::string m_addr;
+  };
+
+  namespace{
+    auto dummy0 = Factory<Processor>::Register<DataReceiverProcessor>(DataReceiverProcessor::m_id_factory);
+  }
+
+  DataReceiverProcessor::DataReceiverProcessor()
+    :Processor("DataReceiverProcessor"), m_addr("tcp://45000"){
+  }
+
+  void DataReceiverProcessor::ProcessCommand(const std::string& cmd, const std::string& arg){
+    if(cmd == "LISTEN")
+      m_addr = arg;
+  }
+
+  void DataReceiverProcessor::OnReceive(ConnectionSPC /*id*/, EventSP ev){
+    ForwardEvent(ev);
+  }
+
+  void DataReceiverProcessor::ProduceEvent(){
+    std::string addr = Listen(m_addr);
+    EUDAQ_INFO("DataReceiverProcessor: listening on " + addr);
+    while(!GetProducerStopFlag())
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    StopListen();
+  }
+}
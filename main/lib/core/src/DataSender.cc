@@ -4,13 +4,21 @@
 #include "eudaq/BufferSerializer.hh"
 #include "eudaq/Logger.hh"
 #include "eudaq/DataSender.hh"
+#include "eudaq/Utils.hh"
+
+#include <algorithm>
+#include <cmath>
 
 namespace eudaq {
 
   DataSender::DataSender(const std::string & type, const std::string & name)
     : m_type(type),
     m_name(name),
-    m_packetCounter(0) {}
+    m_packetCounter(0),
+    m_sampling(1),
+    m_sel_c(0),
+    m_offered_c(0),
+    m_backlog(0) {}
 
 
   DataSender::~DataSender(){
@@ -74,6 +82,18 @@ namespace eudaq {
     i1 = packet.find(' ');
     if (std::string(packet, 0, i1) != "OK")
       EUDAQ_THROW("DataSender:: Connection refused by DataReceiver server: " + packet);
+    // the receiver may append the selection of events it wants to get
+    m_sel = EventSelection();
+    if (i1 != std::string::npos)
+      m_sel = EventSelection::FromString(packet.substr(i1 + 1));
+    m_sampling = m_sel.GetSampling();
+    m_sel_c = 0;
+    m_offered_c = 0;
+    m_backlog = 0;
+    m_tp_poll = std::chrono::steady_clock::now();
+    m_tp_feedback = m_tp_poll;
+    if (!m_sel.IsEmpty())
+      EUDAQ_INFO("DataSender:: selection of " + server + ": " + m_sel.ToString());
     m_is_connected = true;
     m_fut_async = std::async(std::launch::async, &DataSender::AsyncSending, this);
   }
@@ -82,6 +102,14 @@ namespace eudaq {
     if (!m_dataclient)
       EUDAQ_THROW("DataSender:: Transport not connected error");
 
+    auto tp_now = std::chrono::steady_clock::now();
+    if (tp_now - m_tp_poll > std::chrono::milliseconds(100)) {
+      m_tp_poll = tp_now;
+      ReadFeedback();
+    }
+    if (!m_sel.IsEmpty() && !Select(*ev))
+      return;
+
     /*
     std::unique_lock<std::mutex> lk(m_mx_qu_ev);
     m_qu_ev.push(ev);
@@ -99,6 +127,73 @@ namespace eudaq {
     m_dataclient->SendPacket(ser);
   }
 
+  EventSelection DataSender::GetEventSelection() const {
+    return m_sel;
+  }
+
+  uint32_t DataSender::GetSampling() const {
+    return m_sampling;
+  }
+
+  bool DataSender::Select(const Event &ev){
+    if (ev.IsBORE() || ev.IsEORE())
+      return true;
+    if (!m_sel.Match(ev))
+      return false;
+    m_offered_c++;
+    return m_sel_c++ % m_sampling == 0;
+  }
+
+  void DataSender::ReadFeedback(){
+    std::string packet;
+    try {
+      while (m_dataclient->ReceivePacket(&packet, 0)) {
+	size_t i1 = packet.find(' ');
+	std::string cmd(packet, 0, i1);
+	std::string par = i1 == std::string::npos ? "" : packet.substr(i1 + 1);
+	if (cmd == "SELECT") {
+	  m_sel = EventSelection::FromString(par);
+	  m_sampling = m_sel.GetSampling();
+	  m_sel_c = 0;
+	  EUDAQ_INFO("DataSender:: new selection: " + m_sel.ToString());
+	}
+	else if (cmd == "RATE" && m_sel.IsAdaptive()) {
+	  auto vals = split(par, " ", true);
+	  if (vals.size() == 2)
+	    AdaptSampling(from_string(vals[0], 0.0), from_string(vals[1], uint64_t(0)));
+	}
+      }
+    }
+    catch (...) {
+      // a broken connection is reported by the next SendPacket
+    }
+  }
+
+  void DataSender::AdaptSampling(double consumed, uint64_t backlog){
+    auto tp_now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(tp_now - m_tp_feedback).count();
+    m_tp_feedback = tp_now;
+    if (dt <= 0)
+      return;
+    double offered = m_offered_c / dt;
+    m_offered_c = 0;
+    uint32_t base = m_sel.GetSampling();
+    uint32_t last = m_sampling;
+    if (backlog > 100 && backlog >= m_backlog) {
+      // the backlog grows, send no more than the receiver managed to consume
+      uint32_t need = consumed > 0 ? static_cast<uint32_t>(std::ceil(offered / consumed))
+	: 2 * m_sampling;
+      m_sampling = std::max(need, m_sampling + 1);
+    }
+    else if (backlog < 10 && m_sampling > base) {
+      m_sampling = std::max(base, m_sampling - std::max(1u, m_sampling / 4));
+    }
+    m_backlog = backlog;
+    if (m_sampling != last)
+      EUDAQ_DEBUG("DataSender:: adaptive sampling 1/" + std::to_string(m_sampling)
+		  + ", receiver backlog " + std::to_string(backlog));
+  }
+
   bool DataSender::AsyncSending(){
     while(m_is_connected){//TODO:
       std::unique_lock<std::mutex> lk(m_mx_qu_ev);
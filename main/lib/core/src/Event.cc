@@ -2,6 +2,11 @@
 #include "eudaq/BufferSerializer.hh"
 #include "eudaq/Logger.hh"
 
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+
 namespace eudaq {
   
   template class DLLEXPORT Factory<Event>;
@@ -55,6 +60,34 @@ namespace eudaq {
     ds.read(m_ts_end);
     ds.read(m_dspt);
     ds.read(m_tags);
+    if(m_version >= 3){
+      uint32_t n;
+      for(ds.read(n); n>0; n--){
+	uint32_t id;
+	std::string name;
+	ds.read(id);
+	ds.read(name);
+	TagKey::Register(id, name);
+      }
+      ds.read(n);
+      m_typed_tags.resize(n);
+      for(auto &tag: m_typed_tags){
+	uint8_t type;
+	ds.read(tag.key);
+	ds.read(type);
+	tag.type = type;
+	if(type == TAG_BYTES)
+	  ds.read(tag.bytes);
+	else if(type == TAG_UINT32){
+	  uint32_t v;
+	  ds.read(v);
+	  tag.type = TAG_UINT;
+	  tag.value = v;
+	}
+	else
+	  ds.read(tag.value);
+      }
+    }
     ds.read(m_blocks);
     uint32_t n_subev;
     for(ds.read(n_subev); n_subev>0; n_subev--){
@@ -85,8 +118,19 @@ namespace eudaq {
   }
   
   void Event::Serialize(Serializer & ser) const {
+    // a BORE carries the names of its own typed tags, later events only
+    // the key ids; events without typed tags stay at version 2
+    std::map<uint32_t, std::string> keys;
+    if(IsBORE())
+      for(auto &tag: m_typed_tags)
+	keys[tag.key] = TagKey::Name(tag.key);
+    uint32_t version = m_version;
+    if(m_typed_tags.empty())
+      version = std::min<uint32_t>(version, 2);
+    else
+      version = std::max<uint32_t>(version, 3);
     ser.write(m_type);
-    ser.write(m_version);
+    ser.write(version);
     ser.write(m_flags);
     ser.write(m_stm_n);
     ser.write(m_run_n);
@@ -97,6 +141,28 @@ namespace eudaq {
     ser.write(m_ts_end);
     ser.write(m_dspt);
     ser.write(m_tags);
+    if(version >= 3){
+      ser.write((uint32_t)keys.size());
+      for(auto &key: keys){
+	ser.write(key.first);
+	ser.write(key.second);
+      }
+      ser.write((uint32_t)m_typed_tags.size());
+      for(auto &tag: m_typed_tags){
+	ser.write(tag.key);
+	if(tag.type == TAG_UINT && tag.value <= UINT32_MAX){
+	  ser.write((uint8_t)TAG_UINT32);
+	  ser.write((uint32_t)tag.value);
+	}
+	else{
+	  ser.write((uint8_t)tag.type);
+	  if(tag.type == TAG_BYTES)
+	    ser.write(tag.bytes);
+	  else
+	    ser.write(tag.value);
+	}
+      }
+    }
     ser.write(m_blocks);
     ser.write((uint32_t)m_sub_events.size());
     for(auto &ev: m_sub_events){
@@ -112,6 +178,13 @@ namespace eudaq {
     return it->second;
   }
 
+  const std::vector<uint8_t> &Event::GetBlockRef(uint32_t i) const{
+    auto it = m_blocks.find(i);
+    if(it == m_blocks.end())
+      EUDAQ_THROW("No block with ID " + std::to_string(i) + " in the event");
+    return it->second;
+  }
+
   std::vector<uint32_t> Event::GetBlockNumList() const {
     std::vector<uint32_t> vnum;
     for(auto &e : m_blocks){
@@ -134,11 +207,14 @@ namespace eudaq {
        <<"  ->  0x"<< to_hex(m_ts_end, 16) << "</Timestamp>\n";
     os << std::string(offset + 2, ' ') << "<Timestamp>" << m_ts_begin
        <<"  ->  "<< m_ts_end << "</Timestamp>\n";
-    if(!m_tags.empty()){
+    if(!m_tags.empty() || !m_typed_tags.empty()){
       os << std::string(offset + 2, ' ') << "<Tags>\n";
       for (auto &tag: m_tags){
 	os << std::string(offset+4, ' ') << "<Tag>"<< tag.first << "=" << tag.second << "</Tag>\n";
       }
+      for (auto &tag: m_typed_tags){
+	os << std::string(offset+4, ' ') << "<Tag>"<< TagKey::Name(tag.key) << "=" << FormatTypedTag(tag) << "</Tag>\n";
+      }
       os << std::string(offset + 2, ' ') << "</Tags>\n";
     }
     os << std::string(offset + 2, ' ')<<"<Block_Size>"<<m_blocks.size()<<"</Block_Size>\n";
@@ -156,14 +232,114 @@ namespace eudaq {
   
   std::string Event::GetTag(const std::string & name, const std::string & def) const {
     auto i = m_tags.find(name);
-    if (i == m_tags.end()) return def;
-    return i->second;
+    if (i != m_tags.end()) return i->second;
+    if (m_typed_tags.empty()) return def;
+    auto tag = FindTypedTag(str2hash(name));
+    return tag ? FormatTypedTag(*tag) : def;
+  }
+
+  bool Event::HasTag(const std::string &name) const {
+    return m_tags.find(name) != m_tags.end() ||
+      (!m_typed_tags.empty() && FindTypedTag(str2hash(name)));
+  }
+
+  void Event::SetTag(const std::string &name, const std::string &val) {
+    if(!m_typed_tags.empty()){
+      uint32_t id = str2hash(name);
+      for(auto it = m_typed_tags.begin(); it != m_typed_tags.end(); ++it){
+	if(it->key == id){
+	  m_typed_tags.erase(it);
+	  break;
+	}
+      }
+    }
+    m_tags[name] = val;
+  }
+
+  std::map<std::string, std::string> Event::GetTags() const {
+    if(m_typed_tags.empty())
+      return m_tags;
+    auto tags = m_tags;
+    for(auto &tag: m_typed_tags)
+      tags[TagKey::Name(tag.key)] = FormatTypedTag(tag);
+    return tags;
+  }
+
+  void Event::SetTag(const TagKey &key, double val){
+    uint64_t v;
+    std::memcpy(&v, &val, sizeof(v));
+    SetTypedTag(key, TAG_DOUBLE, v);
+  }
+
+  void Event::SetTag(const TagKey &key, const std::vector<uint8_t> &val){
+    SetTypedTag(key, TAG_BYTES, 0).bytes = val;
   }
 
+  bool Event::HasTag(const TagKey &key) const {
+    return FindTypedTag(key.GetId()) || m_tags.find(key.GetName()) != m_tags.end();
+  }
+
+  std::string Event::GetTag(const TagKey &key, const std::string &def) const {
+    auto tag = FindTypedTag(key.GetId());
+    return tag ? FormatTypedTag(*tag) : GetTag(key.GetName(), def);
+  }
 
-  bool Event::HasTag(const std::string &name) const {return m_tags.find(name) != m_tags.end();}
-  void Event::SetTag(const std::string &name, const std::string &val) {m_tags[name] = val;}
-  std::map<std::string, std::string> Event::GetTags() const {return m_tags;}
+  std::string Event::GetTag(const TagKey &key, const char *def) const {
+    return GetTag(key, std::string(def));
+  }
+
+  std::vector<uint8_t> Event::GetTagBytes(const TagKey &key) const {
+    auto tag = FindTypedTag(key.GetId());
+    if(tag && tag->type == TAG_BYTES)
+      return tag->bytes;
+    return std::vector<uint8_t>();
+  }
+
+  Event::TypedTag &Event::SetTypedTag(const TagKey &key, TagType type, uint64_t value){
+    if(!m_tags.empty())
+      m_tags.erase(key.GetName());
+    TypedTag *tag = const_cast<TypedTag*>(FindTypedTag(key.GetId()));
+    if(!tag){
+      m_typed_tags.emplace_back();
+      tag = &m_typed_tags.back();
+      tag->key = key.GetId();
+    }
+    tag->type = type;
+    tag->value = value;
+    tag->bytes.clear();
+    return *tag;
+  }
+
+  const Event::TypedTag *Event::FindTypedTag(uint32_t key) const {
+    for(auto &tag: m_typed_tags)
+      if(tag.key == key)
+	return &tag;
+    return nullptr;
+  }
+
+  std::string Event::FormatTypedTag(const TypedTag &tag){
+    switch(tag.type){
+    case TAG_UINT:
+      return std::to_string(tag.value);
+    case TAG_INT:
+      return std::to_string(int64_t(tag.value));
+    case TAG_DOUBLE:{
+      double d;
+      std::memcpy(&d, &tag.value, sizeof(d));
+      std::ostringstream str;
+      str << std::setprecision(std::numeric_limits<double>::max_digits10) << d;
+      return str.str();
+    }
+    case TAG_BYTES:{
+      std::string str;
+      for(auto b: tag.bytes)
+	str += to_hex(b, 2);
+      return str;
+    }
+    default:
+      return "";
+    }
+  }
     
   void Event::SetFlagBit(uint32_t f) { m_flags |= f;}
   void Event::ClearFlagBit(uint32_t f) { m_flags &= ~f;}
@@ -219,6 +395,19 @@ namespace eudaq {
   size_t Event::GetNumBlock() const { return m_blocks.size(); }
   size_t Event::NumBlocks() const { return m_blocks.size(); }
 
+  size_t Event::GetDataSize() const {
+    size_t bytes = 48 + m_dspt.size();
+    for(auto &tag: m_tags)
+      bytes += tag.first.size() + tag.second.size() + 8;
+    for(auto &tag: m_typed_tags)
+      bytes += tag.bytes.size() + 16;
+    for(auto &block: m_blocks)
+      bytes += block.second.size() + 8;
+    for(auto &ev: m_sub_events)
+      bytes += ev->GetDataSize();
+    return bytes;
+  }
+
   std::string Event::GetTag(const std::string &name, const char *def) const{
     return GetTag(name, std::string(def));
   }
@@ -0,0 +1,123 @@
+#include "eudaq/EventSelection.hh"
+#include "eudaq/Utils.hh"
+#include "eudaq/Exception.hh"
+#include <string>
+#include <stdexcept>
+
+namespace eudaq {
+
+  namespace {
+    // decimal, or hex with 0x as written by older versions
+    uint32_t ParseNumber(const std::string &str){
+      try{
+	return static_cast<uint32_t>(std::stoul(str, nullptr, 0));
+      }
+      catch(const std::exception &){
+	EUDAQ_THROW("EventSelection: invalid number " + str);
+      }
+    }
+  }
+
+  EventSelection::EventSelection()
+    :m_sampling(1), m_flag_mask(0), m_adaptive(false){
+  }
+
+  EventSelection EventSelection::FromString(const std::string &str){
+    EventSelection sel;
+    for(auto &item: split(str, ";", true)){
+      size_t i = item.find('=');
+      if(i == std::string::npos)
+	continue;
+      std::string key = trim(item.substr(0, i));
+      std::string val = trim(item.substr(i+1));
+      if(key == "sampling")
+	sel.SetSampling(from_string(val, uint32_t(1)));
+      else if(key == "types")
+	for(auto &t: split(val, ",", true))
+	  sel.AddType(ParseNumber(t));
+      else if(key == "flags")
+	sel.SetFlagMask(ParseNumber(val));
+      else if(key == "device")
+	sel.SetDevice(val);
+      else if(key == "adaptive")
+	sel.SetAdaptive(from_string(val, uint32_t(0)) != 0);
+    }
+    return sel;
+  }
+
+  std::string EventSelection::ToString() const{
+    std::string str = "sampling=" + std::to_string(m_sampling);
+    if(!m_types.empty()){
+      str += ";types=";
+      for(auto it = m_types.begin(); it != m_types.end(); ++it){
+	if(it != m_types.begin())
+	  str += ",";
+	str += std::to_string(*it);
+      }
+    }
+    if(m_flag_mask)
+      str += ";flags=" + std::to_string(m_flag_mask);
+    if(!m_device.empty())
+      str += ";device=" + m_device;
+    if(m_adaptive)
+      str += ";adaptive=1";
+    return str;
+  }
+
+  bool EventSelection::IsEmpty() const{
+    return m_sampling <= 1 && m_types.empty() && !m_flag_mask
+      && m_device.empty() && !m_adaptive;
+  }
+
+  bool EventSelection::Match(const Event &ev) const{
+    if(ev.IsBORE() || ev.IsEORE())
+      return true;
+    if((ev.GetFlag() & m_flag_mask) != m_flag_mask)
+      return false;
+    if(!m_types.empty() && !MatchType(ev))
+      return false;
+    if(!m_device.empty() && !MatchDevice(ev))
+      return false;
+    return true;
+  }
+
+  bool EventSelection::MatchType(const Event &ev) const{
+    if(m_types.count(ev.GetType()))
+      return true;
+    for(uint32_t i = 0; i < ev.GetNumSubEvent(); i++)
+      if(MatchType(*ev.GetSubEvent(i)))
+	return true;
+    return false;
+  }
+
+  bool EventSelection::MatchDevice(const Event &ev) const{
+    if(ev.GetDescription() == m_device)
+      return true;
+    for(uint32_t i = 0; i < ev.GetNumSubEvent(); i++)
+      if(MatchDevice(*ev.GetSubEvent(i)))
+	return true;
+    return false;
+  }
+
+  void EventSelection::SetSampling(uint32_t n){m_sampling = n?n:1;}
+  uint32_t EventSelection::GetSampling() const{return m_sampling;}
+  void EventSelection::AddType(uint32_t type){m_types.insert(type);}
+  void EventSelection::ClearTypes(){m_types.clear();}
+  const std::set<uint32_t>& EventSelection::GetTypes() const{return m_types;}
+  void EventSelection::SetFlagMask(uint32_t mask){m_flag_mask = mask;}
+  uint32_t EventSelection::GetFlagMask() const{return m_flag_mask;}
+  void EventSelection::SetDevice(const std::string &dspt){m_device = dspt;}
+  std::string EventSelection::GetDevice() const{return m_device;}
+  void EventSelection::SetAdaptive(bool adaptive){m_adaptive = adaptive;}
+  bool EventSelection::IsAdaptive() const{return m_adaptive;}
+
+  bool EventSelection::operator==(const EventSelection &other) const{
+    return m_sampling == other.m_sampling && m_types == other.m_types
+      && m_flag_mask == other.m_flag_mask && m_device == other.m_device
+      && m_adaptive == other.m_adaptive;
+  }
+
+  bool EventSelection::operator!=(const EventSelection &other) const{
+    return !(*this == other);
+  }
+}
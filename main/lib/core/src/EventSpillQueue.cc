@@ -0,0 +1,140 @@
+#include "eudaq/EventSpillQueue.hh"
+#include "eudaq/Logger.hh"
+
+#include <cstdio>
+
+namespace eudaq {
+
+  EventSpillQueue::EventSpillQueue(const std::string &name,
+				   const std::string &filename,
+				   uint64_t replay_bytes)
+    :m_name(name), m_filename(filename), m_replay_bytes(replay_bytes),
+     m_bytes_mem(0), m_bytes_spill(0), m_tp_push(std::chrono::steady_clock::now()){
+  }
+
+  EventSpillQueue::~EventSpillQueue(){
+    CloseSpill();
+  }
+
+  void EventSpillQueue::Push(EventSPC ev){
+    m_tp_push = std::chrono::steady_clock::now();
+    if(!ev)
+      return;
+    if(!m_que_spill.empty()){
+      WriteSpill(ev);
+      return;
+    }
+    uint64_t bytes = ev->GetDataSize();
+    m_que_mem.emplace_back(std::move(ev), bytes);
+    m_bytes_mem += bytes;
+  }
+
+  EventSPC EventSpillQueue::Front(){
+    if(m_que_mem.empty())
+      Replay();
+    if(m_que_mem.empty())
+      return nullptr;
+    return m_que_mem.front().first;
+  }
+
+  void EventSpillQueue::Pop(){
+    if(m_que_mem.empty())
+      Replay();
+    if(m_que_mem.empty())
+      return;
+    m_bytes_mem -= m_que_mem.front().second;
+    m_que_mem.pop_front();
+  }
+
+  bool EventSpillQueue::Empty() const{
+    return m_que_mem.empty() && m_que_spill.empty();
+  }
+
+  size_t EventSpillQueue::Size() const{
+    return m_que_mem.size() + m_que_spill.size();
+  }
+
+  void EventSpillQueue::Clear(){
+    m_que_mem.clear();
+    m_bytes_mem = 0;
+    CloseSpill();
+    // a queue reused for the next run starts its stall timeout afresh
+    m_tp_push = std::chrono::steady_clock::now();
+  }
+
+  uint64_t EventSpillQueue::Spill(){
+    // events already on disk come after everything in memory, so the memory
+    // part can only be moved while the file is empty
+    if(!m_que_spill.empty() || m_que_mem.size() < 2)
+      return 0;
+    uint64_t bytes_before = m_bytes_spill;
+    while(m_que_mem.size() > 1){
+      auto it = m_que_mem.begin() + 1;
+      m_bytes_mem -= it->second;
+      EventSPC ev = std::move(it->first);
+      m_que_mem.erase(it);
+      WriteSpill(std::move(ev));
+    }
+    return m_bytes_spill - bytes_before;
+  }
+
+  uint64_t EventSpillQueue::GetMemoryBytes() const{
+    return m_bytes_mem;
+  }
+
+  uint64_t EventSpillQueue::GetSpilledBytes() const{
+    return m_bytes_spill;
+  }
+
+  std::string EventSpillQueue::GetName() const{
+    return m_name;
+  }
+
+  std::chrono::steady_clock::time_point EventSpillQueue::GetLastPush() const{
+    return m_tp_push;
+  }
+
+  void EventSpillQueue::WriteSpill(EventSPC ev){
+    if(!m_ser){
+      m_ser.reset(new FileSerializer(m_filename, true));
+      EUDAQ_INFO("EventSpillQueue: spilling events of "+m_name+" to "+m_filename);
+    }
+    uint64_t bytes_before = m_ser->FileBytes();
+    m_ser->write(*ev);
+    uint64_t bytes = m_ser->FileBytes() - bytes_before;
+    m_que_spill.push_back(bytes);
+    m_bytes_spill += bytes;
+  }
+
+  void EventSpillQueue::Replay(){
+    if(m_que_spill.empty())
+      return;
+    m_ser->Flush();
+    if(!m_des)
+      m_des.reset(new FileDeserializer(m_filename));
+    uint64_t bytes_read = 0;
+    while(!m_que_spill.empty() && bytes_read < m_replay_bytes){
+      uint32_t id;
+      m_des->PreRead(id);
+      EventSP ev = Factory<Event>::Create<Deserializer&>(id, *m_des);
+      uint64_t bytes = ev->GetDataSize();
+      m_que_mem.emplace_back(std::move(ev), bytes);
+      m_bytes_mem += bytes;
+      bytes_read += m_que_spill.front();
+      m_bytes_spill -= m_que_spill.front();
+      m_que_spill.pop_front();
+    }
+    if(m_que_spill.empty())
+      CloseSpill();
+  }
+
+  void EventSpillQueue::CloseSpill(){
+    bool opened = m_ser || m_des;
+    m_des.reset();
+    m_ser.reset();
+    m_que_spill.clear();
+    m_bytes_spill = 0;
+    if(opened)
+      std::remove(m_filename.c_str());
+  }
+}
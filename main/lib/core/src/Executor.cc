@@ -0,0 +1,102 @@
+#include "eudaq/Executor.hh"
+
+namespace eudaq {
+
+  namespace {
+    thread_local Executor *t_executor = nullptr;
+    thread_local uint32_t t_worker = 0;
+  }
+
+  Executor::Executor(uint32_t n)
+    :m_pending(0), m_stop(false){
+    if(!n)
+      n = std::thread::hardware_concurrency();
+    // keep going when a task blocks for a while
+    if(n < 2)
+      n = 2;
+    for(uint32_t i = 0; i < n; i++)
+      m_workers.emplace_back(new Worker);
+    for(uint32_t i = 0; i < n; i++)
+      m_threads.emplace_back(&Executor::Run, this, i);
+  }
+
+  Executor::~Executor(){
+    {
+      std::lock_guard<std::mutex> lk(m_mtx_sleep);
+      m_stop = true;
+    }
+    m_cv_sleep.notify_all();
+    for(auto &th: m_threads)
+      if(th.joinable())
+	th.join();
+  }
+
+  Executor& Executor::Instance(){
+    // never destroyed: detached producer threads may still submit at exit
+    static Executor *executor = new Executor;
+    return *executor;
+  }
+
+  uint32_t Executor::GetThreadN() const{
+    return static_cast<uint32_t>(m_threads.size());
+  }
+
+  bool Executor::IsWorkerThread() const{
+    return t_executor == this;
+  }
+
+  void Executor::Submit(std::function<void()> task){
+    Worker &w = (t_executor == this) ? *m_workers[t_worker] : m_shared;
+    // counted before it is queued, so that the count never goes below zero
+    m_pending++;
+    {
+      std::lock_guard<std::mutex> lk(w.mtx);
+      w.tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lk(m_mtx_sleep);
+    }
+    m_cv_sleep.notify_one();
+  }
+
+  bool Executor::TakeFrom(Worker &w, std::function<void()> &task){
+    std::lock_guard<std::mutex> lk(w.mtx);
+    if(w.tasks.empty())
+      return false;
+    task = std::move(w.tasks.front());
+    w.tasks.pop_front();
+    return true;
+  }
+
+  bool Executor::TakeTask(uint32_t i, uint64_t n, std::function<void()> &task){
+    // now and then look at the shared queue first, so that tasks queueing
+    // themselves again on a worker do not hold back the others
+    if(n % 16 == 0 && TakeFrom(m_shared, task))
+      return true;
+    if(TakeFrom(*m_workers[i], task) || TakeFrom(m_shared, task))
+      return true;
+    uint32_t nw = static_cast<uint32_t>(m_workers.size());
+    for(uint32_t k = 1; k < nw; k++)
+      if(TakeFrom(*m_workers[(i + k) % nw], task))
+	return true;
+    return false;
+  }
+
+  void Executor::Run(uint32_t i){
+    t_executor = this;
+    t_worker = i;
+    std::function<void()> task;
+    for(uint64_t n = 0; ; n++){
+      if(TakeTask(i, n, task)){
+	m_pending--;
+	task();
+	task = nullptr;
+	continue;
+      }
+      std::unique_lock<std::mutex> lk(m_mtx_sleep);
+      m_cv_sleep.wait(lk, [this]{return m_stop || m_pending > 0;});
+      if(m_stop && m_pending == 0)
+	return;
+    }
+  }
+}
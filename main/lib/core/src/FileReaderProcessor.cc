@@ -0,0 +1,68 @@
+#include "eudaq/Processor.hh"
+#include "eudaq/FileReader.hh"
+#include "eudaq/Logger.hh"
+
+namespace eudaq {
+
+  /// Source reading the events of FILE, with the FileReader FORMAT or the
+  /// one given by the file extension (TYPE names the processor in a pipeline)
+  class FileReaderProcessor: public Processor {
+  public:
+    FileReaderProcessor();
+    void ProduceEvent() override;
+    void ProcessCommand(const std::string& cmd, const std::string& arg) override;
+    static const uint32_t m_id_factory = cstr2hash("FileReaderProcessor");
+  private:
+    std::string m_path;
+    std::string m_format;
+  };
+
+  namespace{
+    auto dummy0 = Factory<Processor>::Register<FileReaderProcessor>(FileReaderProcessor::m_id_factory);
+  }
+
+  FileReaderProcessor::FileReaderProcessor()
+    :Processor("FileReaderProcessor"){
+  }
+
+  void FileReaderProcessor::ProcessCommand(const std::string& cmd, const std::string& arg){
+    if(cmd == "FILE")
+      m_path = arg;
+    else if(cmd == "FORMAT")
+      m_format = arg;
+  }
+
+  void FileReaderProcessor::ProduceEvent(){
+    std::string type = m_format;
+    if(type.empty())
+      type = m_path.substr(m_path.find_last_of(".")+1);
+    if(type == "raw")
+      type = "native";
+    // runs on the producer thread, nothing above it catches
+    try{
+      FileReaderUP reader = Factory<FileReader>::MakeUnique(str2hash(type), m_path);
+      if(!reader){
+	EUDAQ_ERROR("FileReaderProcessor: can not read " + m_path + " of type " + type);
+	return;
+      }
+      EventBatch evs;
+      while(!GetProducerStopFlag()){
+	auto ev = reader->GetNextEvent();
+	if(!ev)
+	  break;
+	if(!evs.Accepts(ev) || evs.size() >= 64){
+	  ForwardEvents(evs);
+	  evs.clear();
+	}
+	evs.push_back(ev);
+      }
+      ForwardEvents(evs);
+    }
+    catch(const std::exception &e){
+      EUDAQ_ERROR("FileReaderProcessor: reading " + m_path + " failed: " + e.what());
+    }
+    catch(...){
+      EUDAQ_ERROR("FileReaderProcessor: reading " + m_path + " failed");
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#include "eudaq/Processor.hh"
+#include "eudaq/FileWriter.hh"
+#include "eudaq/Logger.hh"
+
+namespace eudaq {
+
+  /// Writes the events to FILE with the FileWriter FORMAT or the one given
+  /// by the file extension, and forwards them
+  class FileWriterProcessor: public Processor {
+  public:
+    FileWriterProcessor();
+    void ProcessEvents(const EventBatch& evs) override;
+    void ProcessCommand(const std::string& cmd, const std::string& arg) override;
+    static const uint32_t m_id_factory = cstr2hash("FileWriterProcessor");
+  private:
+    std::string m_path;
+    std::string m_format;
+    FileWriterUP m_writer;
+    bool m_failed;
+  };
+
+  namespace{
+    auto dummy0 = Factory<Processor>::Register<FileWriterProcessor>(FileWriterProcessor::m_id_factory);
+  }
+
+  FileWriterProcessor::FileWriterProcessor()
+    :Processor("FileWriterProcessor"), m_failed(false){
+  }
+
+  void FileWriterProcessor::ProcessCommand(const std::string& cmd, const std::string& arg){
+    if(cmd == "FILE")
+      m_path = arg;
+    else if(cmd == "FORMAT")
+      m_format = arg;
+  }
+
+  // runs in an Executor task, which does not catch: a failure is logged and
+  // the events are only forwarded from then on
+  void FileWriterProcessor::ProcessEvents(const EventBatch& evs){
+    if(!m_writer && !m_failed){
+      std::string type = m_format;
+      if(type.empty())
+	type = m_path.substr(m_path.find_last_of(".")+1);
+      if(type == "raw")
+	type = "native";
+      try{
+	m_writer = Factory<FileWriter>::MakeUnique(str2hash(type), m_path);
+      }
+      catch(const std::exception &e){
+	EUDAQ_ERROR("FileWriterProcessor: can not write " + m_path + ": " + e.what());
+	m_failed = true;
+      }
+      if(!m_writer && !m_failed){
+	EUDAQ_ERROR("FileWriterProcessor: can not write " + m_path + " of type " + type);
+	m_failed = true;
+      }
+    }
+    for(auto &ev: evs){
+      if(m_writer){
+	try{
+	  m_writer->WriteEvent(ev);
+	}
+	catch(const std::exception &e){
+	  EUDAQ_ERROR("FileWriterProcessor: writing " + m_path + " failed: " + e.what());
+	  m_writer.reset();
+	  m_failed = true;
+	}
+      }
+      ForwardEvent(ev);
+    }
+  }
+}
@@ -0,0 +1,85 @@
+#include "eudaq/LatencyHistogram.hh"
+
+#include <cstdio>
+
+namespace eudaq {
+
+  LatencyHistogram::LatencyHistogram(){
+    Reset();
+  }
+
+  uint32_t LatencyHistogram::BucketIndex(uint64_t ns){
+    const uint64_t sub_n = uint64_t(1) << SUB_BITS;
+    if(ns < sub_n)
+      return uint32_t(ns);
+    uint32_t msb = 0;
+    for(uint32_t step = 32; step; step >>= 1)
+      if(ns >> (msb + step))
+	msb += step;
+    uint32_t shift = msb - SUB_BITS;
+    return ((shift + 1) << SUB_BITS) + uint32_t((ns >> shift) & (sub_n - 1));
+  }
+
+  uint64_t LatencyHistogram::BucketUpper(uint32_t i){
+    const uint64_t sub_n = uint64_t(1) << SUB_BITS;
+    if(i < sub_n)
+      return i;
+    uint32_t shift = (i >> SUB_BITS) - 1;
+    uint64_t low = (sub_n + (i & (sub_n - 1))) << shift;
+    return low + ((uint64_t(1) << shift) - 1);
+  }
+
+  std::string LatencyHistogram::ToMs(uint64_t ns){
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", ns * 1e-6);
+    return buf;
+  }
+
+  void LatencyHistogram::Record(uint64_t ns){
+    m_counts[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while(ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed));
+  }
+
+  uint64_t LatencyHistogram::GetCount() const{
+    return m_total.load(std::memory_order_relaxed);
+  }
+
+  uint64_t LatencyHistogram::GetMax() const{
+    return m_max.load(std::memory_order_relaxed);
+  }
+
+  double LatencyHistogram::GetMean() const{
+    uint64_t n = GetCount();
+    return n ? double(m_sum.load(std::memory_order_relaxed)) / n : 0;
+  }
+
+  uint64_t LatencyHistogram::GetQuantile(double q) const{
+    uint64_t n = GetCount();
+    if(!n)
+      return 0;
+    uint64_t rank = uint64_t(q * n);
+    if(rank >= n)
+      rank = n - 1;
+    uint64_t acc = 0;
+    for(uint32_t i = 0; i < NUM_BUCKETS; i++){
+      acc += m_counts[i].load(std::memory_order_relaxed);
+      if(acc > rank){
+	uint64_t upper = BucketUpper(i);
+	uint64_t max = GetMax();
+	return upper < max ? upper : max;
+      }
+    }
+    return GetMax();
+  }
+
+  void LatencyHistogram::Reset(){
+    for(auto &c: m_counts)
+      c.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+  }
+}
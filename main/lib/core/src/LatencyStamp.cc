@@ -0,0 +1,56 @@
+#include "eudaq/LatencyStamp.hh"
+
+#include <chrono>
+
+namespace eudaq {
+
+  uint64_t LatencyStamp::Now(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  std::string LatencyStamp::TagName(Hop hop){
+    switch(hop){
+    case PRODUCER_SEND: return "EUDAQ_TS_PRODUCER_SEND";
+    case COLLECTOR_RECEIVE: return "EUDAQ_TS_COLLECTOR_RECEIVE";
+    case COLLECTOR_WRITE: return "EUDAQ_TS_COLLECTOR_WRITE";
+    case MONITOR_RECEIVE: return "EUDAQ_TS_MONITOR_RECEIVE";
+    default: return "EUDAQ_TS_UNKNOWN";
+    }
+  }
+
+  void LatencyStamp::Stamp(Event &ev, Hop hop, uint64_t ns){
+    ev.SetTag(TagName(hop), std::to_string(ns));
+  }
+
+  uint64_t LatencyStamp::Get(const Event &ev, Hop hop){
+    uint64_t ns = ev.GetTag(TagName(hop), uint64_t(0));
+    if(ns)
+      return ns;
+    for(uint32_t i = 0; i < ev.GetNumSubEvent(); i++){
+      uint64_t sub = Get(*ev.GetSubEvent(i), hop);
+      if(sub && (!ns || sub < ns))
+	ns = sub;
+    }
+    return ns;
+  }
+
+  bool LatencyStamp::GetInterval(const Event &ev, Hop from, Hop to, uint64_t &ns){
+    uint64_t t0 = Get(ev, from);
+    uint64_t t1 = Get(ev, to);
+    if(!t0 || !t1 || t1 < t0)
+      return false;
+    ns = t1 - t0;
+    return true;
+  }
+
+  void LatencyStamp::Propagate(Event &ev, Hop hop){
+    for(int h = PRODUCER_SEND; h < hop; h++){
+      if(ev.HasTag(TagName(Hop(h))))
+	continue;
+      uint64_t ns = Get(ev, Hop(h));
+      if(ns)
+	Stamp(ev, Hop(h), ns);
+    }
+  }
+}
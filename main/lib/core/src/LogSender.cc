@@ -6,9 +6,29 @@
 
 namespace eudaq {
 
+  struct LogSender::Slot {
+    std::atomic<uint64_t> seq;
+    LogMessage msg;
+    bool console;
+  };
+
+  namespace {
+    const size_t RING_SIZE = 4096; // a power of two
+    const std::chrono::seconds REPORT_PERIOD(1);
+  }
+
   LogSender::LogSender()
-      : m_logclient(0), m_errlevel(Status::LVL_DEBUG),
-        m_shownotconnected(false) {}
+      : m_logclient(0), m_level(Status::LVL_DEBUG),
+        m_errlevel(Status::LVL_DEBUG), m_shownotconnected(false),
+        m_ring(new Slot[RING_SIZE]), m_ring_mask(RING_SIZE - 1), m_head(0),
+        m_tail(0), m_done(0), m_stop(false), m_sleeping(false),
+        m_rate(200), m_burst(1000), m_last_console(false),
+        m_last_dropped(false), m_repeat(0),
+        m_tokens(1000), m_drop_full(0), m_drop_rate(0), m_drop_reported(0) {
+    for (size_t i = 0; i < RING_SIZE; i++)
+      m_ring[i].seq = i;
+    m_refill = m_last_report = m_last_emit = std::chrono::steady_clock::now();
+  }
 
   void LogSender::Connect(const std::string &type, const std::string &name,
                           const std::string &server) {
@@ -61,20 +81,21 @@ namespace eudaq {
   }
 
   void LogSender::Disconnect() {
+    Flush();
     std::lock_guard<std::recursive_mutex> lk(m_mutex);
     delete m_logclient;
+    m_logclient = 0;
     isConnected = false;
   }
 
   void LogSender::SendLogMessage(const LogMessage &msg) {
-
-    SendLogMessage(msg, std::cout, std::cerr);
+    Push(msg, true);
   }
 
   void LogSender::SendLogMessage(const LogMessage &msg, std::ostream &out,
                                  std::ostream &error_out) {
-    std::lock_guard<std::recursive_mutex> lk(m_mutex);
     if (msg.GetLevel() >= m_level) {
+      std::lock_guard<std::recursive_mutex> lk(m_mutex);
       if (msg.GetLevel() >= m_errlevel) {
         if (m_name != "")
           error_out << "[" << m_name << "] ";
@@ -85,30 +106,201 @@ namespace eudaq {
         out << msg << std::endl;
       }
     }
+    Push(msg, false);
+  }
+
+  void LogSender::SetRateLimit(double per_second, uint32_t burst) {
+    m_rate = per_second;
+    m_burst = burst;
+  }
+
+  void LogSender::StartSender() {
+    std::call_once(m_start, [this]() {
+      m_thread = std::thread(&LogSender::SenderLoop, this);
+    });
+  }
+
+  bool LogSender::Push(const LogMessage &msg, bool console) {
+    StartSender();
+    uint64_t pos = m_head.load(std::memory_order_relaxed);
+    // the last quarter of the ring is kept for errors
+    uint64_t limit = msg.GetLevel() < Status::LVL_ERROR
+                         ? (m_ring_mask + 1) / 4 * 3 : m_ring_mask + 1;
+    Slot *slot;
+    while (true) {
+      if (pos - m_done >= limit) {
+        m_drop_full++;
+        return false;
+      }
+      slot = &m_ring[pos & m_ring_mask];
+      uint64_t seq = slot->seq.load(std::memory_order_acquire);
+      int64_t diff = int64_t(seq - pos);
+      if (diff == 0) {
+        if (m_head.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        m_drop_full++;
+        return false;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    }
+    slot->msg = msg;
+    slot->console = console;
+    slot->seq.store(pos + 1);
+    if (m_sleeping) {
+      { std::lock_guard<std::mutex> lk(m_mtx_wake); }
+      m_cv_wake.notify_one();
+    }
+    return true;
+  }
+
+  void LogSender::Flush() {
+    StartSender();
+    if (std::this_thread::get_id() == m_thread.get_id())
+      return;
+    uint64_t target = m_head;
+    std::unique_lock<std::mutex> lk(m_mtx_wake);
+    m_cv_wake.notify_one();
+    m_cv_done.wait_for(lk, std::chrono::seconds(5),
+                       [&]() { return m_done >= target; });
+  }
+
+  void LogSender::SenderLoop() {
+    while (true) {
+      Slot &slot = m_ring[m_tail & m_ring_mask];
+      if (slot.seq.load(std::memory_order_acquire) == m_tail + 1) {
+        LogMessage msg(slot.msg);
+        bool console = slot.console;
+        slot.seq.store(m_tail + m_ring_mask + 1, std::memory_order_release);
+        m_tail++;
+        Handle(msg, console);
+        m_done = m_tail;
+        continue;
+      }
+      auto now = std::chrono::steady_clock::now();
+      if (m_repeat && now - m_last_emit >= REPORT_PERIOD)
+        FlushRepeats();
+      if (now - m_last_report >= REPORT_PERIOD)
+        ReportDropped();
+      std::unique_lock<std::mutex> lk(m_mtx_wake);
+      m_cv_done.notify_all();
+      if (m_stop) {
+        lk.unlock();
+        FlushRepeats();
+        ReportDropped();
+        break;
+      }
+      m_sleeping = true;
+      if (slot.seq.load() != m_tail + 1)
+        m_cv_wake.wait_for(lk, std::chrono::milliseconds(100));
+      m_sleeping = false;
+    }
+  }
+
+  void LogSender::Handle(LogMessage &msg, bool console) {
+    if (m_last && m_last_console == console &&
+        m_last->GetLevel() == msg.GetLevel() &&
+        m_last->GetMessage() == msg.GetMessage()) {
+      m_repeat++;
+      return;
+    }
+    FlushRepeats();
+    auto now = std::chrono::steady_clock::now();
+    m_last.reset(new LogMessage(msg));
+    m_last_console = console;
+    m_last_emit = now;
+    m_last_dropped = false;
+    double rate = m_rate;
+    if (rate > 0 && msg.GetLevel() < Status::LVL_ERROR) {
+      double burst = m_burst;
+      m_tokens += rate * std::chrono::duration<double>(now - m_refill).count();
+      if (m_tokens > burst)
+        m_tokens = burst;
+      m_refill = now;
+      if (m_tokens < 1) {
+        m_drop_rate++;
+        m_last_dropped = true;
+        return;
+      }
+      m_tokens -= 1;
+    }
+    Emit(msg, console);
+  }
+
+  void LogSender::FlushRepeats() {
+    if (!m_repeat)
+      return;
+    if (m_last_dropped) {
+      // repeats of a message that was not shown are not shown either
+      m_drop_rate += m_repeat;
+      m_repeat = 0;
+      return;
+    }
+    LogMessage msg("Last message repeated " + std::to_string(m_repeat) +
+                       " times",
+                   LogMessage::Level(m_last->GetLevel()));
+    m_repeat = 0;
+    m_last_emit = std::chrono::steady_clock::now();
+    Emit(msg, m_last_console);
+  }
+
+  void LogSender::ReportDropped() {
+    m_last_report = std::chrono::steady_clock::now();
+    uint64_t dropped = m_drop_full + m_drop_rate;
+    if (dropped == m_drop_reported)
+      return;
+    LogMessage msg(std::to_string(dropped - m_drop_reported) +
+                       " log messages dropped (" +
+                       std::to_string(dropped) + " in total)",
+                   LogMessage::LVL_WARN);
+    m_drop_reported = dropped;
+    Emit(msg, true);
+  }
+
+  void LogSender::Emit(const LogMessage &msg, bool console) {
+    std::lock_guard<std::recursive_mutex> lk(m_mutex);
+    if (console && msg.GetLevel() >= m_level) {
+      std::ostream &out = msg.GetLevel() >= m_errlevel ? std::cerr : std::cout;
+      if (m_name != "")
+        out << "[" << m_name << "] ";
+      out << msg << std::endl;
+    }
 
     if (!m_logclient) {
       if (m_shownotconnected)
-        error_out << "### Log message triggered but Logger not connected ###\n";
+        std::cerr << "### Log message triggered but Logger not connected ###\n";
     } else {
       BufferSerializer ser;
       msg.Serialize(ser);
       try {
         m_logclient->SendPacket(ser);
       } catch (const eudaq::Exception &e) {
-        error_out << "Caught exception trying to log message '" << msg
+        std::cerr << "Caught exception trying to log message '" << msg
                   << "': " << e.what() << std::endl;
-        error_out << " -> will delete LogClient" << std::endl;
+        std::cerr << " -> will delete LogClient" << std::endl;
         delete m_logclient;
         m_logclient = 0;
       } catch (...) {
-        error_out << "Caught exception trying to log message '" << msg << "'! "
-                  << std::endl;
-        error_out << " -> will delete LogClient" << std::endl;
+        std::cerr << "Caught exception trying to log message '" << msg
+                  << "'! " << std::endl;
+        std::cerr << " -> will delete LogClient" << std::endl;
         delete m_logclient;
         m_logclient = 0;
       }
     }
   }
 
-  LogSender::~LogSender() { delete m_logclient; }
+  LogSender::~LogSender() {
+    if (m_thread.joinable()) {
+      {
+        std::lock_guard<std::mutex> lk(m_mtx_wake);
+        m_stop = true;
+      }
+      m_cv_wake.notify_one();
+      m_thread.join();
+    }
+    delete m_logclient;
+  }
 }
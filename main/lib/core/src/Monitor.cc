@@ -4,6 +4,7 @@
 #include "eudaq/BufferSerializer.hh"
 #include "eudaq/Logger.hh"
 #include "eudaq/Utils.hh"
+#include "eudaq/LatencyStamp.hh"
 #include <iostream>
 #include <ostream>
 #include <ctime>
@@ -68,6 +69,18 @@ namespace eudaq {
     auto conf = GetConfiguration();
     try {
       SetStatus(Status::STATE_UNCONF, "Configuring");
+      EventSelection sel = GetEventSelection();
+      sel.SetSampling(conf->Get("EUDAQ_MN_SAMPLING", sel.GetSampling()));
+      std::string types = conf->Get("EUDAQ_MN_SELECT_TYPES", "");
+      if(!types.empty()){
+	sel.ClearTypes();
+	for(auto &t: split(types, ";,", true))
+	  sel.AddType(str2hash(t));
+      }
+      sel.SetFlagMask(conf->Get("EUDAQ_MN_SELECT_FLAGS", sel.GetFlagMask()));
+      sel.SetDevice(conf->Get("EUDAQ_MN_SELECT_DEVICE", sel.GetDevice()));
+      sel.SetAdaptive(conf->Get("EUDAQ_MN_ADAPTIVE_SAMPLING", int(sel.IsAdaptive())) != 0);
+      SetEventSelection(sel);
       DoConfigure();
       CommandReceiver::OnConfigure();
     }catch (const Exception &e) {
@@ -83,6 +96,7 @@ namespace eudaq {
       m_data_addr = Listen(m_data_addr);
       SetStatusTag("_SERVER", m_data_addr);
       m_evt_c = 0;
+      m_lat_receive.Reset();
       DoStartRun();
       CommandReceiver::OnStartRun();
     } catch (const Exception &e) {
@@ -128,12 +142,20 @@ namespace eudaq {
     
   void Monitor::OnStatus(){
     SetStatusTag("EventN", std::to_string(m_evt_c));
+    if(m_lat_receive.GetCount())
+      m_lat_receive.ExportTags("Latency", [this](const std::string &k, const std::string &v){SetStatusTag(k, v);});
     DoStatus();
     CommandReceiver::OnStatus();
   }
 
   void Monitor::OnReceive(ConnectionSPC id, EventSP ev){
     m_evt_c ++;
+    if(ev->HasTag(LatencyStamp::TagName(LatencyStamp::COLLECTOR_WRITE))){
+      uint64_t ns;
+      LatencyStamp::Stamp(*ev, LatencyStamp::MONITOR_RECEIVE);
+      if(LatencyStamp::GetInterval(*ev, LatencyStamp::PRODUCER_SEND, LatencyStamp::MONITOR_RECEIVE, ns))
+	m_lat_receive.Record(ns);
+    }
     DoReceive(ev);
   }
   
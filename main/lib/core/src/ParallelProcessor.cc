@@ -0,0 +1,79 @@
+#include "eudaq/ParallelProcessor.hh"
+#include "eudaq/Executor.hh"
+
+namespace eudaq {
+
+  namespace{
+    auto dummy0 = Factory<Processor>::Register<ParallelProcessor>(cstr2hash("ParallelProcessor"));
+  }
+
+  ParallelProcessor::ParallelProcessor()
+    :Processor("ParallelProcessor"), m_seq_in(0), m_seq_out(0), m_inflight(0){
+  }
+
+  void ParallelProcessor::AddReplica(ProcessorSP ps){
+    std::unique_ptr<Replica> r(new Replica);
+    r->ps = ps;
+    m_replicas.push_back(std::move(r));
+  }
+
+  size_t ParallelProcessor::GetReplicaN() const{
+    return m_replicas.size();
+  }
+
+  // called by the hub or consumer of this processor, one batch at a time
+  void ParallelProcessor::ProcessEvents(const EventBatch& evs){
+    if(m_replicas.empty())
+      EUDAQ_THROW("ParallelProcessor: no replica to process the events");
+    uint64_t seq = m_seq_in++;
+    m_inflight++;
+    Replica *r = m_replicas[seq % m_replicas.size()].get();
+    std::unique_lock<std::mutex> lk(r->mtx);
+    r->que.push_back(std::make_pair(seq, evs));
+    if(!r->scheduled){
+      r->scheduled = true;
+      lk.unlock();
+      auto self = std::static_pointer_cast<ParallelProcessor>(shared_from_this());
+      Executor::Instance().Submit([self, r](){self->RunReplica(r);});
+    }
+  }
+
+  void ParallelProcessor::RunReplica(Replica *r){
+    for(uint32_t n = 0; ; n++){
+      std::unique_lock<std::mutex> lk(r->mtx);
+      if(r->que.empty()){
+	r->scheduled = false;
+	return;
+      }
+      if(n == 64){
+	lk.unlock();
+	auto self = std::static_pointer_cast<ParallelProcessor>(shared_from_this());
+	Executor::Instance().Submit([self, r](){self->RunReplica(r);});
+	return;
+      }
+      auto item = std::move(r->que.front());
+      r->que.pop_front();
+      lk.unlock();
+      std::vector<EventBatch> out;
+      r->ps->ProcessInto(item.second, out);
+      Complete(item.first, std::move(out));
+    }
+  }
+
+  // forward everything that is complete up to the first gap in the sequence
+  void ParallelProcessor::Complete(uint64_t seq, std::vector<EventBatch> &&out){
+    std::lock_guard<std::mutex> lk(m_mtx_merge);
+    m_done[seq] = std::move(out);
+    while(!m_done.empty() && m_done.begin()->first == m_seq_out){
+      for(auto &evs: m_done.begin()->second)
+	ForwardEvents(evs);
+      m_done.erase(m_done.begin());
+      m_seq_out++;
+      m_inflight--;
+    }
+  }
+
+  bool ParallelProcessor::IsIdle(){
+    return m_inflight == 0 && Processor::IsIdle();
+  }
+}
@@ -6,11 +6,35 @@ using namespace eudaq;
 template DLLEXPORT
 std::map<uint32_t, typename Factory<Processor>::UP_BASE (*)()>& Factory<Processor>::Instance<>();
 
+namespace{
+  // the events a processor forwards while it handles a batch
+  struct ForwardBuffer{
+    Processor *ps;
+    EventBatch evs;
+    std::vector<EventBatch> *capture; // kept here instead of forwarded
+  };
+  thread_local ForwardBuffer *t_fwd = nullptr;
+  // most events taken from a queue at once
+  const size_t BATCH_MAX = 64;
+
+  void FlushForward(ForwardBuffer &fwd){
+    if(fwd.evs.empty())
+      return;
+    EventBatch evs;
+    std::swap(evs, fwd.evs);
+    if(fwd.capture)
+      fwd.capture->push_back(std::move(evs));
+    else
+      fwd.ps->ForwardEvents(evs);
+  }
+}
+
 ProcessorSP Processor::MakeShared(const std::string& pstype,
 				  std::initializer_list
 				  <std::pair<const std::string, const std::string>> l){
   ProcessorSP ps = Factory<Processor>::MakeShared(str2hash(pstype));
-  ps->m_th_hub = std::thread(&Processor::HubProcessing, ps.get());
+  if(!ps)
+    EUDAQ_THROW("Processor: unknown processor type " + pstype);
   ps->m_ps_hub = ps;
   for(auto &p: l){
     ps->ProcessSysCommand(p.first, p.second);
@@ -20,41 +44,71 @@ ProcessorSP Processor::MakeShared(const std::string& pstype,
 
 
 Processor::Processor(const std::string& dsp)
-  :m_description(dsp), m_csm_go_stop(0), m_hub_go_stop(0), m_hub_force(0){
+  :m_description(dsp), m_csm_go_stop(0), m_hub_go_stop(0), m_hub_force(0),
+   m_csm_on(false), m_csm_scheduled(false), m_hub_scheduled(false),
+   m_que_max(0), m_reg_c(0){
   m_instance_n = static_cast<uint32_t>(reinterpret_cast<uint64_t>(this));
 }
 
+// the queued tasks hold the processor, so its queues are empty by now
 Processor::~Processor(){
   StopProducer();
-  if(m_th_hub.joinable()){
-    m_hub_go_stop = true;
-    m_th_hub.join();
-    m_hub_go_stop = false;
-  }
-  if(m_th_csm.joinable()){
-    m_csm_go_stop = true;
-    m_th_csm.join();
-    m_csm_go_stop = false;
-  }
 };
 
 void Processor::ProcessEvent(EventSPC ev){
   ForwardEvent(ev);
 }
 
-void Processor::Processing(EventSPC ev){
-  if(m_th_csm.joinable() && !m_csm_go_stop){
-    std::unique_lock<std::mutex> lk(m_mtx_csm);
-    m_que_csm.push_back(ev);
-    m_cv_csm.notify_all();
+void Processor::ProcessEvents(const EventBatch& evs){
+  for(auto &ev: evs)
+    ProcessEvent(ev);
+}
+
+void Processor::ProcessBatch(const EventBatch& evs, std::vector<EventBatch>* capture){
+  ForwardBuffer fwd = {this, EventBatch(), capture};
+  ForwardBuffer *prev = t_fwd;
+  t_fwd = &fwd;
+  try{
+    ProcessEvents(evs);
+  }catch(...){
+    t_fwd = prev;
+    throw;
+  }
+  t_fwd = prev;
+  FlushForward(fwd);
+}
+
+void Processor::ProcessInto(const EventBatch& evs, std::vector<EventBatch>& out){
+  ProcessBatch(evs, &out);
+}
+
+void Processor::Processing(const EventBatch& evs){
+  std::unique_lock<std::mutex> lk(m_mtx_csm);
+  if(m_csm_on && !m_csm_go_stop){
+    m_que_csm.insert(m_que_csm.end(), evs.begin(), evs.end());
+    if(!m_csm_scheduled){
+      m_csm_scheduled = true;
+      lk.unlock();
+      auto ps = shared_from_this();
+      Executor::Instance().Submit([ps](){ps->ConsumeEvent();});
+    }
   }
   else{
-    ProcessEvent(ev);
+    lk.unlock();
+    ProcessBatch(evs);
   }
 }
 
 
 void Processor::ForwardEvent(EventSPC ev) {
+  if(t_fwd && t_fwd->ps == this){
+    if(!t_fwd->evs.Accepts(ev))
+      FlushForward(*t_fwd);
+    t_fwd->evs.push_back(ev);
+    if(!t_fwd->capture && t_fwd->evs.size() >= BATCH_MAX)
+      FlushForward(*t_fwd);
+    return;
+  }
   std::lock_guard<std::mutex> lk(m_mtx_output);
   uint32_t evid = ev->GetEventID();
   for(auto &psev: m_ps_downstream){
@@ -65,12 +119,42 @@ void Processor::ForwardEvent(EventSPC ev) {
   }
 }
 
+void Processor::ForwardEvents(const EventBatch& evs){
+  // keep the order with what was forwarded one by one before
+  if(t_fwd && t_fwd->ps == this){
+    FlushForward(*t_fwd);
+    if(t_fwd->capture){
+      if(!evs.empty())
+	t_fwd->capture->push_back(evs);
+      return;
+    }
+  }
+  if(evs.empty())
+    return;
+  std::lock_guard<std::mutex> lk(m_mtx_output);
+  uint32_t evid = evs.GetEventID();
+  for(auto &psev: m_ps_downstream){
+    auto &evset = psev.second;
+    if(evset.find(evid)!=evset.end()){
+      psev.first->RegisterEvents(evs);
+    }
+  }
+}
+
 void Processor::RegisterEvent(EventSPC ev){
+  m_reg_c++;
   std::lock_guard<std::mutex> lk(m_mtx_input);
   auto ps_hub = m_ps_hub.lock();
   ps_hub->RegisterProcessing(shared_from_this(), ev);
 }
 
+void Processor::RegisterEvents(const EventBatch& evs){
+  m_reg_c++;
+  std::lock_guard<std::mutex> lk(m_mtx_input);
+  auto ps_hub = m_ps_hub.lock();
+  ps_hub->RegisterProcessing(shared_from_this(), evs);
+}
+
 void Processor::RegisterDownstream(ProcessorSP ps, const std::set<uint32_t>& evset){
   std::lock_guard<std::mutex> lk(m_mtx_output);
   auto evs = evset;
@@ -121,10 +205,8 @@ void Processor::RegisterUpstream(ProcessorSP up, ProcessorWP hub){
     for(auto &e: m_ps_downstream){
       e.first->RegisterUpstream(shared_from_this(), m_ps_hub);
     }
-    if(to_stop && m_th_hub.joinable()){
-	m_hub_go_stop = true;
-	m_th_hub.join();
-    }
+    if(to_stop)
+      StopHub();
     return;
   }
   //unforced, diff, muilt upstreams, self hub ready
@@ -132,7 +214,7 @@ void Processor::RegisterUpstream(ProcessorSP up, ProcessorWP hub){
     return;
   }
   //unforced, diff, muilt upstreams, self hub unready  
-  m_th_hub = std::thread(&Processor::HubProcessing, this);
+  m_hub_go_stop = false;
   m_ps_hub = shared_from_this();
   for(auto &e: m_ps_downstream){
     e.first->RegisterUpstream(shared_from_this(),  m_ps_hub);
@@ -147,47 +229,131 @@ void Processor::RegisterProcessing(ProcessorSP ps, EventSPC ev){ //NOTE:: return
     lk.unlock();
     return; //register to new hub_ps of that ps
   }
+  WaitHubSpace(lk);
   m_que_hub.push_back(std::make_pair(ps, ev));
-  m_cv_hub.notify_all();
+  if(!m_hub_scheduled){
+    m_hub_scheduled = true;
+    lk.unlock();
+    auto hub = shared_from_this();
+    Executor::Instance().Submit([hub](){hub->HubProcessing();});
+  }
+}
+
+void Processor::RegisterProcessing(ProcessorSP ps, const EventBatch& evs){
+  std::unique_lock<std::mutex> lk(m_mtx_hub);
+  if(m_hub_go_stop){
+    lk.unlock();
+    return;
+  }
+  WaitHubSpace(lk);
+  for(auto &ev: evs)
+    m_que_hub.push_back(std::make_pair(ps, ev));
+  if(!m_hub_scheduled){
+    m_hub_scheduled = true;
+    lk.unlock();
+    auto hub = shared_from_this();
+    Executor::Instance().Submit([hub](){hub->HubProcessing();});
+  }
 }
 
+// Only threads outside of the Executor, i.e. producers, wait for the hub
+// queue to have space. A worker waiting could hold up the very task that
+// drains the queue.
+void Processor::WaitHubSpace(std::unique_lock<std::mutex>& lk){
+  if(!m_que_max || Executor::Instance().IsWorkerThread())
+    return;
+  m_cv_hub.wait(lk, [this](){return m_que_hub.size() < m_que_max || m_hub_go_stop;});
+}
+
+// Runs as an Executor task. Following events for the same processor and of
+// the same id are passed on as one batch. After a number of batches it
+// queues itself again, so that a busy processor does not hold the thread
+// from the others.
 void Processor::HubProcessing(){
-  while(!m_hub_go_stop){
+  for(size_t n = 0; ; n++){
     std::unique_lock<std::mutex> lk(m_mtx_hub);
     if(m_que_hub.empty()){
-      if(m_cv_hub.wait_for(lk,std::chrono::microseconds(100))==std::cv_status::timeout)
-	continue;
+      m_hub_scheduled = false;
+      m_cv_hub.notify_all();
+      return;
+    }
+    if(n == BATCH_MAX){
+      lk.unlock();
+      auto hub = shared_from_this();
+      Executor::Instance().Submit([hub](){hub->HubProcessing();});
+      return;
     }
     ProcessorSP ps = m_que_hub.front().first;
-    EventSPC ev(m_que_hub.front().second);
-    m_que_hub.pop_front();
+    EventBatch evs;
+    while(!m_que_hub.empty() && evs.size() < BATCH_MAX
+	  && m_que_hub.front().first == ps && evs.Accepts(m_que_hub.front().second)){
+      evs.push_back(std::move(m_que_hub.front().second));
+      m_que_hub.pop_front();
+    }
     lk.unlock();
-    ps->Processing(ev);
-  }
-  std::unique_lock<std::mutex> lk(m_mtx_hub);
-  for(auto &ps_ev: m_que_hub){
-    ps_ev.first->Processing(ps_ev.second);
+    if(m_que_max)
+      m_cv_hub.notify_all();
+    ps->Processing(evs);
   }
-  m_que_hub.clear();
 }
 
 void Processor::ConsumeEvent(){
-  while(!m_csm_go_stop){
+  for(size_t n = 0; ; n++){
     std::unique_lock<std::mutex> lk(m_mtx_csm);
     if(m_que_csm.empty()){
-      if(m_cv_csm.wait_for(lk,std::chrono::microseconds(100))==std::cv_status::timeout)
-	continue;
+      m_csm_scheduled = false;
+      m_cv_csm.notify_all();
+      return;
+    }
+    if(n == BATCH_MAX){
+      lk.unlock();
+      auto ps = shared_from_this();
+      Executor::Instance().Submit([ps](){ps->ConsumeEvent();});
+      return;
+    }
+    EventBatch evs;
+    while(!m_que_csm.empty() && evs.size() < BATCH_MAX && evs.Accepts(m_que_csm.front())){
+      evs.push_back(std::move(m_que_csm.front()));
+      m_que_csm.pop_front();
     }
-    EventSPC ev(m_que_csm.front());
-    m_que_csm.pop_front();
     lk.unlock();
-    ProcessEvent(ev);
+    ProcessBatch(evs);
   }
-  std::unique_lock<std::mutex> lk(m_mtx_csm);
-  for(auto &ev: m_que_csm){
-    ProcessEvent(ev);
+}
+
+bool Processor::IsIdle(){
+  {
+    std::lock_guard<std::mutex> lk(m_mtx_hub);
+    if(m_hub_scheduled || !m_que_hub.empty())
+      return false;
   }
-  m_que_csm.clear();
+  std::lock_guard<std::mutex> lk(m_mtx_csm);
+  return !m_csm_scheduled && m_que_csm.empty();
+}
+
+// Events registered afterwards are dropped, the queued ones are processed.
+// Must not be called from the processing of this hub.
+void Processor::StopHub(){
+  std::unique_lock<std::mutex> lk(m_mtx_hub);
+  m_hub_go_stop = true;
+  m_cv_hub.notify_all();
+  m_cv_hub.wait(lk, [this](){return !m_hub_scheduled;});
+}
+
+// Events are processed directly again once the queued ones are done
+void Processor::StopConsumer(){
+  std::unique_lock<std::mutex> lk(m_mtx_csm);
+  if(!m_csm_on)
+    return;
+  m_csm_go_stop = true;
+  m_cv_csm.wait(lk, [this](){return !m_csm_scheduled;});
+  m_csm_on = false;
+  m_csm_go_stop = false;
+}
+
+void Processor::WaitProducer(){
+  if(m_th_pdc.joinable())
+    m_th_pdc.join();
 }
 
 void Processor::StopProducer(){
@@ -214,22 +380,19 @@ void Processor::ProcessSysCommand(const std::string& cmd, const std::string& arg
     break;
   }
   case cstr2hash("SYS:CS:RUN"):{
-    m_th_csm = std::thread(&Processor::ConsumeEvent, this);
+    std::lock_guard<std::mutex> lk(m_mtx_csm);
+    m_csm_on = true;
     break;
   }
   case cstr2hash("SYS:CS:STOP"):{
-    if(m_th_csm.joinable()){
-      m_csm_go_stop = true;
-      m_th_csm.join();
-      m_csm_go_stop = false;
-    }
+    StopConsumer();
     break;
   }
   case cstr2hash("SYS:HB:FORCE"):{
     std::lock_guard<std::mutex> lk(m_mtx_input);
     m_hub_force = true;
     if(m_ps_hub.lock()!=shared_from_this()){
-      m_th_hub = std::thread(&Processor::HubProcessing, this);
+      m_hub_go_stop = false;
       m_ps_hub = shared_from_this();
     }
   }
@@ -243,6 +406,11 @@ void Processor::ProcessSysCommand(const std::string& cmd, const std::string& arg
     m_ev_out_default.erase(str2hash(arg));
     break;
   }
+  case cstr2hash("SYS:QUE:MAX"):{
+    std::lock_guard<std::mutex> lk(m_mtx_hub);
+    m_que_max = std::stoul(arg);
+    break;
+  }
   case cstr2hash("SYS:PSID"):{
     m_instance_n = std::stoul(arg);
     break;
@@ -0,0 +1,156 @@
+#include "eudaq/ProcessorPipeline.hh"
+#include "eudaq/ParallelProcessor.hh"
+#include "eudaq/Exception.hh"
+#include "eudaq/Utils.hh"
+
+#include <set>
+#include <chrono>
+#include <thread>
+
+namespace eudaq {
+
+  namespace{
+    std::vector<std::string> SplitList(const std::string &str){
+      std::vector<std::string> items;
+      for(auto &e: split(str, ";,", true)){
+	std::string item = trim(e);
+	if(!item.empty())
+	  items.push_back(item);
+      }
+      return items;
+    }
+  }
+
+  ProcessorPipeline::ProcessorPipeline(const Configuration &conf_in){
+    Configuration conf(conf_in);
+    if(!conf.SetSection("Pipeline"))
+      EUDAQ_THROW("ProcessorPipeline: no [Pipeline] section");
+    m_names = SplitList(conf.Get("PROCESSORS", ""));
+    if(m_names.empty())
+      EUDAQ_THROW("ProcessorPipeline: no PROCESSORS in [Pipeline]");
+    for(auto &name: m_names){
+      if(m_ps.count(name))
+	EUDAQ_THROW("ProcessorPipeline: processor " + name + " declared twice");
+      m_ps[name] = MakeProcessor(conf, name);
+    }
+    for(auto &name: m_names){
+      conf.SetSection("Processor." + name);
+      auto inputs = SplitList(conf.Get("INPUT", ""));
+      if(inputs.empty()){
+	m_sources.push_back(m_ps[name]);
+	continue;
+      }
+      std::set<uint32_t> evset;
+      for(auto &type: SplitList(conf.Get("INPUT_EVENTS", "")))
+	evset.insert(str2hash(type));
+      for(auto &input: inputs){
+	auto it = m_ps.find(input);
+	if(it == m_ps.end())
+	  EUDAQ_THROW("ProcessorPipeline: unknown INPUT " + input + " of processor " + name);
+	it->second->RegisterDownstream(m_ps[name], evset);
+      }
+    }
+  }
+
+  ProcessorPipeline::~ProcessorPipeline(){
+    for(auto &ps: m_sources)
+      ps->StopProducer();
+  }
+
+  ProcessorSP ProcessorPipeline::MakeProcessor(const Configuration &conf, const std::string &name){
+    if(!conf.SetSection("Processor." + name))
+      EUDAQ_THROW("ProcessorPipeline: no [Processor." + name + "] section");
+    std::string type = conf.Get("TYPE", "");
+    if(type.empty())
+      EUDAQ_THROW("ProcessorPipeline: no TYPE for processor " + name);
+    static const std::set<std::string> reserved =
+      {"TYPE", "INPUT", "INPUT_EVENTS", "EVENTS", "PARALLEL", "QUEUE_MAX", "HUB", "CONSUMER"};
+    std::vector<std::string> cmds;
+    for(auto &key: conf.Keylist())
+      if(!reserved.count(key))
+	cmds.push_back(key + "=" + conf.Get(key, ""));
+
+    ProcessorSP ps;
+    uint32_t parallel = conf.Get("PARALLEL", 1);
+    // the replicas all get the same commands, they must not share a file
+    // or a connection
+    static const std::set<std::string> unique =
+      {"FileReaderProcessor", "FileWriterProcessor", "DataReceiverProcessor"};
+    if(parallel > 1 && (SplitList(conf.Get("INPUT", "")).empty() || unique.count(type)))
+      EUDAQ_THROW("ProcessorPipeline: processor " + name + " of TYPE " + type + " can not run in PARALLEL");
+    if(parallel > 1){
+      ps = Processor::MakeShared("ParallelProcessor");
+      auto par = std::dynamic_pointer_cast<ParallelProcessor>(ps);
+      for(uint32_t i = 0; i < parallel; i++){
+	auto replica = Processor::MakeShared(type);
+	for(auto &cmd: cmds)
+	  replica<<cmd;
+	par->AddReplica(replica);
+      }
+    }
+    else{
+      ps = Processor::MakeShared(type);
+      for(auto &cmd: cmds)
+	ps<<cmd;
+    }
+    for(auto &evtype: SplitList(conf.Get("EVENTS", "RawEvent")))
+      ps+evtype;
+    uint32_t que_max = conf.Get("QUEUE_MAX", 0);
+    if(que_max)
+      ps<<("SYS:QUE:MAX=" + std::to_string(que_max));
+    if(conf.Get("HUB", 0))
+      ps<<"SYS:HB:FORCE";
+    if(conf.Get("CONSUMER", 0))
+      ps<<"SYS:CS:RUN";
+    return ps;
+  }
+
+  void ProcessorPipeline::Start(){
+    for(auto &ps: m_sources)
+      ps<<"SYS:PD:RUN";
+  }
+
+  uint64_t ProcessorPipeline::GetRegisteredN() const{
+    uint64_t n = 0;
+    for(auto &e: m_ps)
+      n += e.second->GetRegisteredN();
+    return n;
+  }
+
+  bool ProcessorPipeline::IsIdle() const{
+    for(auto &e: m_ps)
+      if(!e.second->IsIdle())
+	return false;
+    return true;
+  }
+
+  void ProcessorPipeline::Wait(){
+    for(auto &ps: m_sources)
+      ps->WaitProducer();
+    // an event moving on between the checks shows up in the count
+    while(true){
+      uint64_t n = GetRegisteredN();
+      if(IsIdle() && n == GetRegisteredN())
+	break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  void ProcessorPipeline::Stop(){
+    for(auto &ps: m_sources)
+      ps->StopProducer();
+    Wait();
+  }
+
+  ProcessorSP ProcessorPipeline::GetProcessor(const std::string &name) const{
+    auto it = m_ps.find(name);
+    return it == m_ps.end() ? nullptr : it->second;
+  }
+
+  void ProcessorPipeline::Print(std::ostream &os) const{
+    os << "<Pipeline>\n";
+    for(auto &name: m_names)
+      m_ps.at(name)->Print(os, 2);
+    os << "</Pipeline>\n";
+  }
+}
@@ -1,5 +1,6 @@
 #include "eudaq/TransportClient.hh"
 #include "eudaq/Producer.hh"
+#include "eudaq/LatencyStamp.hh"
 
 namespace eudaq {
 
@@ -12,6 +13,7 @@ namespace eudaq {
     : CommandReceiver("Producer", name, runcontrol){
     m_evt_c = 0;
     m_pdc_n = str2hash(GetFullName());
+    m_stamp = false;
   }
 
   void Producer::OnInitialise(){
@@ -43,6 +45,7 @@ namespace eudaq {
       if(!conf)
 	EUDAQ_THROW("No Configuration Section for OnConfigure");
       m_pdc_n = conf->Get("EUDAQ_ID", m_pdc_n);
+      m_stamp = conf->Get("EUDAQ_LATENCY_STAMPS", 0) != 0;
       DoConfigure();
       CommandReceiver::OnConfigure();
     }catch (const std::exception &e) {
@@ -161,6 +164,8 @@ namespace eudaq {
     ev->SetEventN(m_evt_c);
     m_evt_c ++;
     ev->SetDeviceN(m_pdc_n);
+    if(m_stamp)
+      LatencyStamp::Stamp(*ev, LatencyStamp::PRODUCER_SEND);
     std::unique_lock<std::mutex> lk(m_mtx_sender);
     auto senders = m_senders; //hold on the ptrs
     lk.unlock();
@@ -1,6 +1,130 @@
 #include "eudaq/StandardPlane.hh"
 
+#include <algorithm>
+#include <cmath>
+
 namespace eudaq{
+  CompactPlaneHits::CompactPlaneHits(uint8_t pix_bytes)
+    : m_pix_bytes(pix_bytes), m_offsets(1, 0) {
+    if (pix_bytes != 0 && pix_bytes != 1 && pix_bytes != 2 && pix_bytes != 4)
+      EUDAQ_THROW("Unsupported pixel width " + to_string((int)pix_bytes) +
+		  " in CompactPlaneHits");
+  }
+
+  CompactPlaneHits::CompactPlaneHits(Deserializer &ds) {
+    ds.read(m_pix_bytes);
+    ds.read(m_offsets);
+    ds.read(m_x);
+    ds.read(m_y);
+    ds.read(m_pix);
+    ds.read(m_time);
+    ds.read(m_pivot);
+    if (m_pix_bytes != 0 && m_pix_bytes != 1 && m_pix_bytes != 2 && m_pix_bytes != 4)
+      EUDAQ_THROW("Unsupported pixel width " + to_string((int)m_pix_bytes) +
+		  " in CompactPlaneHits");
+    size_t n = m_x.size();
+    if (m_offsets.empty() || m_offsets.front() != 0 || m_offsets.back() != n ||
+	!std::is_sorted(m_offsets.begin(), m_offsets.end()) ||
+	m_y.size() != n || m_pix.size() != n * m_pix_bytes ||
+	(!m_time.empty() && m_time.size() != n) ||
+	(!m_pivot.empty() && m_pivot.size() != (n + 7) / 8))
+      EUDAQ_THROW("Inconsistent CompactPlaneHits");
+  }
+
+  void CompactPlaneHits::Serialize(Serializer &ser) const {
+    ser.write(m_pix_bytes);
+    ser.write(m_offsets);
+    ser.write(m_x);
+    ser.write(m_y);
+    ser.write(m_pix);
+    ser.write(m_time);
+    ser.write(m_pivot);
+  }
+
+  void CompactPlaneHits::Clear() {
+    m_offsets.assign(1, 0);
+    m_x.clear();
+    m_y.clear();
+    m_pix.clear();
+    m_time.clear();
+    m_pivot.clear();
+  }
+
+  void CompactPlaneHits::AddFrame() { m_offsets.push_back(m_x.size()); }
+
+  void CompactPlaneHits::PushHit(uint16_t x, uint16_t y, int32_t pix,
+				 uint64_t time_ps, bool pivot) {
+    if (m_offsets.size() < 2)
+      AddFrame();
+    uint32_t n = m_x.size();
+    m_x.push_back(x);
+    m_y.push_back(y);
+    uint32_t upix = static_cast<uint32_t>(pix);
+    for (uint8_t b = 0; b < m_pix_bytes; ++b) {
+      m_pix.push_back(upix & 0xff);
+      upix >>= 8;
+    }
+    if (time_ps || m_time.size()) {
+      m_time.resize(n, 0);
+      m_time.push_back(time_ps);
+    }
+    if (pivot || m_pivot.size()) {
+      m_pivot.resize(n / 8 + 1, 0);
+      if (pivot)
+	m_pivot[n / 8] |= 1 << (n % 8);
+    }
+    m_offsets.back() = n + 1;
+  }
+
+  bool CompactPlaneHits::CanStorePixel(double pix) const {
+    if (m_pix_bytes == 0)
+      return pix == 1;
+    double range = static_cast<double>(1ULL << (8 * m_pix_bytes - 1));
+    return pix == std::floor(pix) && pix >= -range && pix < range;
+  }
+
+  uint8_t CompactPlaneHits::PixelBytes() const { return m_pix_bytes; }
+
+  uint32_t CompactPlaneHits::NumFrames() const { return m_offsets.size() - 1; }
+
+  uint32_t CompactPlaneHits::NumHits() const { return m_x.size(); }
+
+  uint32_t CompactPlaneHits::FrameBegin(uint32_t frame) const {
+    return m_offsets.at(frame);
+  }
+
+  uint32_t CompactPlaneHits::FrameEnd(uint32_t frame) const {
+    return m_offsets.at(frame + 1);
+  }
+
+  const std::vector<uint16_t> &CompactPlaneHits::XVector() const { return m_x; }
+
+  const std::vector<uint16_t> &CompactPlaneHits::YVector() const { return m_y; }
+
+  int32_t CompactPlaneHits::GetPixel(uint32_t index) const {
+    if (m_pix_bytes == 0)
+      return 1;
+    uint32_t upix = 0;
+    const uint8_t *p = &m_pix.at(index * m_pix_bytes);
+    for (uint8_t b = 0; b < m_pix_bytes; ++b)
+      upix |= static_cast<uint32_t>(p[b]) << (8 * b);
+    // sign-extend from the stored width
+    uint8_t shift = 32 - 8 * m_pix_bytes;
+    return static_cast<int32_t>(upix << shift) >> shift;
+  }
+
+  uint64_t CompactPlaneHits::GetTimestamp(uint32_t index) const {
+    return index < m_time.size() ? m_time[index] : 0;
+  }
+
+  bool CompactPlaneHits::GetPivot(uint32_t index) const {
+    return index / 8 < m_pivot.size() && (m_pivot[index / 8] >> (index % 8) & 1);
+  }
+
+  bool CompactPlaneHits::HasTimestamps() const { return !m_time.empty(); }
+
+  bool CompactPlaneHits::HasPivots() const { return !m_pivot.empty(); }
+
   StandardPlane::StandardPlane()
     : m_id(0), m_xsize(0), m_ysize(0), m_flags(0),
       m_pivotpixel(0), m_result_pix(0), m_result_x(0), m_result_y(0) {}
@@ -20,6 +144,11 @@ namespace eudaq{
     ds.read(m_ysize);
     ds.read(m_flags);
     ds.read(m_pivotpixel);
+    if (GetFlags(FLAG_COMPACT)) {
+      FromCompact(CompactPlaneHits(ds));
+      ds.read(m_mat);
+      return;
+    }
     ds.read(m_pix);
     ds.read(m_x);
     ds.read(m_y);
@@ -34,7 +163,17 @@ namespace eudaq{
     ser.write(m_id);
     ser.write(m_xsize);
     ser.write(m_ysize);
-    ser.write(m_flags);
+    if (GetFlags(FLAG_COMPACT)) {
+      CompactPlaneHits hits(m_compact_pix_bytes);
+      if (ToCompact(hits)) {
+	ser.write(m_flags);
+	ser.write(m_pivotpixel);
+	ser.write(hits);
+	ser.write(m_mat);
+	return;
+      }
+    }
+    ser.write(m_flags & ~FLAG_COMPACT);
     ser.write(m_pivotpixel);
     ser.write(m_pix);
     ser.write(m_x);
@@ -89,7 +228,7 @@ namespace eudaq{
 
   void StandardPlane::PushPixelHelper(uint32_t x, uint32_t y, double p, uint64_t time_ps,
 				      bool pivot, uint32_t frame) {
-    if (frame > m_x.size())
+    if (frame >= m_x.size())
       EUDAQ_THROW("Bad frame number " + to_string(frame) + " in PushPixel");
     m_x[frame].push_back(x);
     m_y[frame].push_back(y);
@@ -101,6 +240,32 @@ namespace eudaq{
     // ";" << m_pix[0].size() << ", " << m_pivot.size() << std::endl;
   }
 
+  void StandardPlane::Reserve(uint32_t frame, size_t n) {
+    if (frame >= m_pix.size() || frame >= m_x.size())
+      EUDAQ_THROW("Bad frame number " + to_string(frame) + " in Reserve");
+    n += m_x[frame].size();
+    m_x[frame].reserve(n);
+    m_y[frame].reserve(n);
+    m_pix[frame].reserve(n);
+    m_time[frame].reserve(n);
+    if (m_pivot.size())
+      m_pivot[frame].reserve(n);
+  }
+
+  size_t StandardPlane::GrowFrame(uint32_t frame, size_t n) {
+    if (frame >= m_pix.size() || frame >= m_x.size())
+      EUDAQ_THROW("Bad frame number " + to_string(frame) + " in AppendHits");
+    size_t offset = m_x[frame].size();
+    m_x[frame].resize(offset + n);
+    m_y[frame].resize(offset + n);
+    m_pix[frame].resize(offset + n, 1);
+    m_time[frame].resize(offset + n, 0);
+    if (m_pivot.size())
+      m_pivot[frame].resize(offset + n, false);
+    m_result_pix = 0;
+    return offset;
+  }
+
   void StandardPlane::SetPixelHelper(uint32_t index, uint32_t x, uint32_t y,
 				     double pix, uint64_t time_ps, bool pivot, uint32_t frame) {
     if (frame >= m_pix.size())
@@ -122,6 +287,71 @@ namespace eudaq{
     }
   }
 
+  bool StandardPlane::ToCompact(CompactPlaneHits &hits) const {
+    size_t frames = m_pix.size();
+    if (m_x.size() != frames || m_y.size() != frames || m_time.size() != frames ||
+	(m_pivot.size() && m_pivot.size() != frames))
+      return false;
+    hits.Clear();
+    for (size_t f = 0; f < frames; ++f) {
+      size_t n = m_pix[f].size();
+      if (m_x[f].size() != n || m_y[f].size() != n || m_time[f].size() != n ||
+	  (m_pivot.size() && m_pivot[f].size() != n))
+	return false;
+      hits.AddFrame();
+      for (size_t i = 0; i < n; ++i) {
+	coord_t x = m_x[f][i];
+	coord_t y = m_y[f][i];
+	if (x < 0 || x > 0xffff || x != std::floor(x) ||
+	    y < 0 || y > 0xffff || y != std::floor(y) ||
+	    !hits.CanStorePixel(m_pix[f][i]))
+	  return false;
+	hits.PushHit(static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+		     static_cast<int32_t>(m_pix[f][i]), m_time[f][i],
+		     m_pivot.size() && m_pivot[f][i]);
+      }
+    }
+    return true;
+  }
+
+  void StandardPlane::FromCompact(const CompactPlaneHits &hits) {
+    uint32_t frames = hits.NumFrames();
+    const auto &x = hits.XVector();
+    const auto &y = hits.YVector();
+    m_pix.assign(frames, std::vector<pixel_t>());
+    m_x.assign(frames, std::vector<coord_t>());
+    m_y.assign(frames, std::vector<coord_t>());
+    m_time.assign(frames, std::vector<uint64_t>());
+    m_pivot.assign(GetFlags(FLAG_WITHPIVOT) ? frames : 0, std::vector<bool>());
+    for (uint32_t f = 0; f < frames; ++f) {
+      uint32_t begin = hits.FrameBegin(f);
+      uint32_t end = hits.FrameEnd(f);
+      m_x[f].assign(x.begin() + begin, x.begin() + end);
+      m_y[f].assign(y.begin() + begin, y.begin() + end);
+      m_pix[f].reserve(end - begin);
+      m_time[f].reserve(end - begin);
+      for (uint32_t i = begin; i < end; ++i) {
+	m_pix[f].push_back(hits.GetPixel(i));
+	m_time[f].push_back(hits.GetTimestamp(i));
+      }
+      if (m_pivot.size())
+	for (uint32_t i = begin; i < end; ++i)
+	  m_pivot[f].push_back(hits.GetPivot(i));
+    }
+    m_compact_pix_bytes = hits.PixelBytes();
+    m_result_pix = 0;
+    m_result_x = 0;
+    m_result_y = 0;
+  }
+
+  void StandardPlane::SetCompact(uint8_t pix_bytes) {
+    if (pix_bytes != 0 && pix_bytes != 1 && pix_bytes != 2 && pix_bytes != 4)
+      EUDAQ_THROW("Unsupported pixel width " + to_string((int)pix_bytes) +
+		  " in SetCompact");
+    m_compact_pix_bytes = pix_bytes;
+    m_flags |= FLAG_COMPACT;
+  }
+
   void StandardPlane::SetFlags(StandardPlane::FLAGS flags) { m_flags |= flags; }
 
   double StandardPlane::GetPixel(uint32_t index, uint32_t frame) const {
@@ -0,0 +1,41 @@
+#include "eudaq/Processor.hh"
+#include "eudaq/StdEventConverter.hh"
+#include "eudaq/Configuration.hh"
+
+namespace eudaq {
+
+  /// Converts the events to StandardEvents, drops those that fail. The
+  /// commands make up the configuration handed to the converters, e.g.
+  /// COMPACT_HITS=1
+  class StdEventConverterProcessor: public Processor {
+  public:
+    StdEventConverterProcessor();
+    void ProcessEvents(const EventBatch& evs) override;
+    void ProcessCommand(const std::string& cmd, const std::string& arg) override;
+    static const uint32_t m_id_factory = cstr2hash("StdEventConverterProcessor");
+  private:
+    ConfigurationSP m_conf;
+  };
+
+  namespace{
+    auto dummy0 = Factory<Processor>::Register<StdEventConverterProcessor>(StdEventConverterProcessor::m_id_factory);
+  }
+
+  StdEventConverterProcessor::StdEventConverterProcessor()
+    :Processor("StdEventConverterProcessor"){
+  }
+
+  void StdEventConverterProcessor::ProcessCommand(const std::string& cmd, const std::string& arg){
+    if(!m_conf)
+      m_conf = std::make_shared<Configuration>();
+    m_conf->SetString(cmd, arg);
+  }
+
+  void StdEventConverterProcessor::ProcessEvents(const EventBatch& evs){
+    for(auto &ev: evs){
+      auto stdev = StandardEvent::MakeShared();
+      if(StdEventConverter::Convert(ev, stdev, m_conf))
+	ForwardEvent(stdev);
+    }
+  }
+}
@@ -0,0 +1,48 @@
+#include "eudaq/TagKey.hh"
+#include "eudaq/Utils.hh"
+
+#include <mutex>
+#include <iostream>
+
+namespace eudaq {
+
+  namespace {
+    std::mutex &RegistryMutex() {
+      static std::mutex mtx;
+      return mtx;
+    }
+
+    std::map<uint32_t, std::string> &Registry() {
+      static std::map<uint32_t, std::string> keys;
+      return keys;
+    }
+  }
+
+  TagKey::TagKey(const std::string &name)
+    :m_id(str2hash(name)), m_name(name){
+    // keys are mostly static objects of modules, so only warn: throwing
+    // here would abort every program loading the module
+    if(!Register(m_id, m_name))
+      std::cerr<<"TagKey: WARNING, "<<name<<" has the same id 0x"<<to_hex(m_id, 8)
+	       <<" as "<<Name(m_id)<<"\n";
+  }
+
+  bool TagKey::Register(uint32_t id, const std::string &name){
+    std::lock_guard<std::mutex> lk(RegistryMutex());
+    auto res = Registry().insert(std::make_pair(id, name));
+    return res.second || res.first->second == name;
+  }
+
+  std::string TagKey::Name(uint32_t id){
+    std::lock_guard<std::mutex> lk(RegistryMutex());
+    auto it = Registry().find(id);
+    if(it != Registry().end())
+      return it->second;
+    return "0x" + to_hex(id, 8);
+  }
+
+  std::map<uint32_t, std::string> TagKey::GetRegistered(){
+    std::lock_guard<std::mutex> lk(RegistryMutex());
+    return Registry();
+  }
+}
@@ -0,0 +1,50 @@
+#include "eudaq/EventSelection.hh"
+#include "eudaq/Utils.hh"
+
+#include <iostream>
+
+using namespace eudaq;
+
+namespace {
+  int failures = 0;
+
+  void Check(bool ok, const std::string &what){
+    if(!ok){
+      std::cerr<<"FAILED: "<<what<<"\n";
+      failures++;
+    }
+  }
+}
+
+int main(){
+  EventSelection sel;
+  sel.SetSampling(10);
+  sel.AddType(cstr2hash("Ex0Raw"));
+  sel.AddType(0xffffffff);
+  sel.SetFlagMask(0x80000010);
+  sel.SetDevice("tlu");
+  sel.SetAdaptive(true);
+
+  std::string str = sel.ToString();
+  try{
+    EventSelection back = EventSelection::FromString(str);
+    Check(back == sel, "round trip of " + str + " gave " + back.ToString());
+  }
+  catch(const std::exception &e){
+    Check(false, "FromString(" + str + ") threw " + e.what());
+  }
+
+  // strings written by older versions use hex
+  try{
+    EventSelection hex = EventSelection::FromString("sampling=2;types=0x12345678;flags=0x10");
+    Check(hex.GetTypes().count(0x12345678) == 1, "hex type");
+    Check(hex.GetFlagMask() == 0x10, "hex flags");
+  }
+  catch(const std::exception &e){
+    Check(false, std::string("hex FromString threw ") + e.what());
+  }
+
+  Check(EventSelection::FromString(EventSelection().ToString()).IsEmpty(),
+	"round trip of the empty selection");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+#include "eudaq/Event.hh"
+#include "eudaq/TagKey.hh"
+#include "eudaq/BufferSerializer.hh"
+
+#include <iostream>
+
+using namespace eudaq;
+
+namespace {
+  int failures = 0;
+
+  void Check(bool ok, const std::string &what){
+    if(!ok){
+      std::cerr<<"FAILED: "<<what<<"\n";
+      failures++;
+    }
+  }
+
+  const TagKey key_u32("TEST_U32");
+  const TagKey key_u64("TEST_U64");
+  const TagKey key_int("TEST_INT");
+  const TagKey key_dbl("TEST_DOUBLE");
+  const TagKey key_bytes("TEST_BYTES");
+
+  void SetTypedTags(Event &ev){
+    ev.SetTag(key_u32, uint64_t(4000000000ull));
+    ev.SetTag(key_u64, uint64_t(1ull << 40));
+    ev.SetTag(key_int, int32_t(-7));
+    ev.SetTag(key_dbl, 2.5);
+    ev.SetTag(key_bytes, std::vector<uint8_t>{1, 2, 3});
+  }
+
+  size_t SerializedSize(const Event &ev){
+    BufferSerializer ser;
+    ev.Serialize(ser);
+    return ser.size();
+  }
+}
+
+int main(){
+  Event ev;
+  ev.SetTag("STRING", "text");
+  SetTypedTags(ev);
+
+  BufferSerializer ser;
+  ev.Serialize(ser);
+  Event back(ser);
+  Check(back.GetVersion() == 3, "typed tags are written as version 3");
+  Check(back.GetTag(key_u32, uint64_t(0)) == 4000000000ull, "uint below 2^32");
+  Check(back.GetTag(key_u64, uint64_t(0)) == (1ull << 40), "uint above 2^32");
+  Check(back.GetTag(key_int, 0) == -7, "int");
+  Check(back.GetTag(key_dbl, 0.) == 2.5, "double");
+  Check(back.GetTagBytes(key_bytes) == std::vector<uint8_t>({1, 2, 3}), "bytes");
+  Check(back.GetTag("STRING") == "text", "string tag next to typed tags");
+
+  // unsigned values below 2^32 take 4 instead of 8 bytes
+  Event small, large;
+  small.SetTag(key_u64, uint64_t(1));
+  large.SetTag(key_u64, uint64_t(1ull << 40));
+  Check(SerializedSize(large) == SerializedSize(small) + 4, "uint32 shortening");
+
+  // only a BORE carries the key table, the others are read by name anyway
+  Event bore, data;
+  bore.SetBORE();
+  SetTypedTags(bore);
+  SetTypedTags(data);
+  Check(SerializedSize(data) < SerializedSize(bore), "no key table outside the BORE");
+  Check(back.GetTag("TEST_INT", 0) == -7, "int by name");
+  Check(back.GetTag("TEST_U64") == std::to_string(1ull << 40), "uint by name as string");
+  Check(back.HasTag("TEST_DOUBLE"), "HasTag by name");
+
+  // events without typed tags stay readable by older versions
+  Event plain;
+  plain.SetTag("STRING", "text");
+  BufferSerializer ser_plain;
+  plain.Serialize(ser_plain);
+  Event plain_back(ser_plain);
+  Check(plain_back.GetVersion() == 2, "no typed tags, version 2");
+  Check(plain_back.GetTag("STRING") == "text", "string tag of version 2");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+#include "eudaq/StandardPlane.hh"
+#include "eudaq/BufferSerializer.hh"
+
+#include <iostream>
+
+using namespace eudaq;
+
+namespace {
+  int failures = 0;
+
+  void Check(bool ok, const std::string &what){
+    if(!ok){
+      std::cerr<<"FAILED: "<<what<<"\n";
+      failures++;
+    }
+  }
+
+  // a binary Mimosa26-like plane with pivot bits, as made by the NI converter
+  StandardPlane MakePlane(bool compact){
+    StandardPlane plane(3, "NI", "MIMOSA26");
+    plane.SetSizeZS(1152, 576, 0, 2, StandardPlane::FLAG_WITHPIVOT |
+		    StandardPlane::FLAG_DIFFCOORDS);
+    if(compact)
+      plane.SetCompact(0);
+    plane.SetPivotPixel(4711);
+    for(uint32_t i = 0; i < 100; i++)
+      plane.PushPixel(i * 11 % 1152, i * 5 % 576, 1, (uint64_t)0, false, 0);
+    for(uint32_t i = 0; i < 50; i++)
+      plane.PushPixel(1151 - i, 575 - i, 1, (uint64_t)0, i % 3 == 0, 1);
+    return plane;
+  }
+
+  void CheckRoundTrip(bool compact){
+    std::string layout = compact ? "compact" : "legacy";
+    StandardPlane plane = MakePlane(compact);
+    BufferSerializer ser;
+    plane.Serialize(ser);
+    StandardPlane back(ser);
+    Check(back.ID() == plane.ID() && back.Type() == plane.Type() &&
+	  back.Sensor() == plane.Sensor(), layout + ": id, type and sensor");
+    Check(back.XSize() == plane.XSize() && back.YSize() == plane.YSize(),
+	  layout + ": size");
+    Check(back.PivotPixel() == plane.PivotPixel(), layout + ": pivot pixel");
+    Check(!!back.GetFlags(StandardPlane::FLAG_COMPACT) == compact, layout + ": compact flag");
+    Check(back.NumFrames() == plane.NumFrames(), layout + ": number of frames");
+    for(uint32_t f = 0; f < plane.NumFrames() && f < back.NumFrames(); f++){
+      Check(back.HitPixels(f) == plane.HitPixels(f), layout + ": hits of frame " + std::to_string(f));
+      for(uint32_t i = 0; i < plane.HitPixels(f) && i < back.HitPixels(f); i++){
+	if(back.GetX(i, f) != plane.GetX(i, f) || back.GetY(i, f) != plane.GetY(i, f) ||
+	   back.GetPixel(i, f) != plane.GetPixel(i, f) ||
+	   back.GetPivot(i, f) != plane.GetPivot(i, f)){
+	  Check(false, layout + ": hit " + std::to_string(i) + " of frame " + std::to_string(f));
+	  break;
+	}
+      }
+    }
+  }
+}
+
+int main(){
+  CheckRoundTrip(false);
+  CheckRoundTrip(true);
+
+  // the compact layout is opt-in, the default stays readable by older builds
+  BufferSerializer legacy, compact;
+  MakePlane(false).Serialize(legacy);
+  MakePlane(true).Serialize(compact);
+  Check(compact.size() < legacy.size(), "compact layout is smaller");
+
+  // a reserved frame is filled without reallocating
+  StandardPlane plane(0, "Test", "Test");
+  plane.SetSizeZS(256, 256, 0);
+  plane.PushPixel(1, 2, 3);
+  plane.Reserve(0, 1000);
+  const StandardPlane::coord_t *x0 = plane.XVector(0).data();
+  for(uint32_t i = 0; i < 1000; i++)
+    plane.PushPixel(i % 256, i / 256, 1);
+  Check(plane.XVector(0).data() == x0 && plane.HitPixels(0) == 1001, "Reserve");
+  bool thrown = false;
+  try{
+    plane.Reserve(1, 10);
+  }
+  catch(const std::exception &){
+    thrown = true;
+  }
+  Check(thrown, "Reserve of a missing frame throws");
+  return failures ? 1 : 0;
+}
@@ -23,6 +23,11 @@ namespace eudaq{
   using LCEventSP = std::shared_ptr<lcio::LCEventImpl>;
   using LCEventSPC = std::shared_ptr<const lcio::LCEventImpl>;
   
+  /**
+   * Converters must not keep state from one event to the next, e.g. from
+   * the BORE: Convert keeps one converter per event type and thread, and
+   * LCEventQueue runs conversions on several threads at once.
+   */
   class DLLEXPORT LCEventConverter:public DataConverter<Event, lcio::LCEventImpl>{
   public:
     LCEventConverter() = default;
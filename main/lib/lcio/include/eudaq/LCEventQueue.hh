@@ -0,0 +1,60 @@
+#ifndef EUDAQ_INCLUDED_LCEventQueue
+#define EUDAQ_INCLUDED_LCEventQueue
+
+#include "eudaq/LCEventConverter.hh"
+
+#include <deque>
+#include <mutex>
+#include <exception>
+#include <condition_variable>
+
+namespace eudaq{
+
+  /**
+   * Converts events to LCEvents on the shared Executor and hands them out
+   * in the order they were pushed. At most depth events are waiting or
+   * being converted; Push blocks while the queue is full. With a depth of
+   * 0, or when Push is called from an Executor task, the event is converted
+   * in the calling thread. Converters therefore have to follow the
+   * requirements documented at LCEventConverter.
+   */
+  class DLLEXPORT LCEventQueue{
+  public:
+    struct Item{
+      EventSPC ev;
+      LCEventSP lcev;
+      bool converted;
+    };
+    LCEventQueue(size_t depth, ConfigurationSPC conf);
+    ~LCEventQueue();
+    LCEventQueue(const LCEventQueue&) = delete;
+    LCEventQueue& operator=(const LCEventQueue&) = delete;
+    /// False if the queue was closed before the event could be queued
+    bool Push(EventSPC ev);
+    /// No more events; Pop returns false once the queue is empty
+    void Close();
+    /// Waits for the next event in order and its conversion, rethrows
+    /// an exception thrown by the converter
+    bool Pop(Item &item);
+    size_t GetDepth() const {return m_depth;}
+
+  private:
+    struct Slot{
+      Item item;
+      bool done;
+      std::exception_ptr err;
+    };
+    void Convert(std::shared_ptr<Slot> slot);
+
+    size_t m_depth;
+    ConfigurationSPC m_conf;
+    std::mutex m_mtx;
+    std::condition_variable m_cv_push;
+    std::condition_variable m_cv_pop;
+    std::deque<std::shared_ptr<Slot>> m_slots;
+    size_t m_running;
+    bool m_closed;
+  };
+}
+
+#endif // EUDAQ_INCLUDED_LCEventQueue
@@ -56,8 +56,13 @@ namespace eudaq{
       }
     }
     
+    // converters may not keep state between events (see LCEventConverter.hh),
+    // so keep one per type and thread instead of creating it for every event
+    thread_local std::map<uint32_t, LCEventConverterUP> t_cvts;
     uint32_t id = d1->GetType();
-    auto cvt = Factory<LCEventConverter>::MakeUnique(id);
+    auto &cvt = t_cvts[id];
+    if(!cvt)
+      cvt = Factory<LCEventConverter>::MakeUnique(id);
     if(cvt){
       return cvt->Converting(d1, d2, conf);
     }
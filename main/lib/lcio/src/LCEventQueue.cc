@@ -0,0 +1,83 @@
+#include "eudaq/LCEventQueue.hh"
+#include "eudaq/Executor.hh"
+#include <algorithm>
+
+namespace eudaq{
+
+  LCEventQueue::LCEventQueue(size_t depth, ConfigurationSPC conf)
+    :m_depth(depth), m_conf(conf), m_running(0), m_closed(false){
+  }
+
+  LCEventQueue::~LCEventQueue(){
+    // the tasks still hold this queue
+    std::unique_lock<std::mutex> lk(m_mtx);
+    m_closed = true;
+    m_cv_push.notify_all();
+    m_cv_pop.wait(lk, [this]{return m_running == 0;});
+  }
+
+  bool LCEventQueue::Push(EventSPC ev){
+    auto slot = std::make_shared<Slot>();
+    slot->item.ev = ev;
+    slot->item.lcev.reset(new lcio::LCEventImpl);
+    slot->item.converted = false;
+    slot->done = false;
+    // a task waiting here for other tasks could stall the whole pool
+    bool inline_cvt = !m_depth || Executor::Instance().IsWorkerThread();
+    {
+      std::unique_lock<std::mutex> lk(m_mtx);
+      m_cv_push.wait(lk, [this]{return m_closed || m_slots.size() < std::max<size_t>(m_depth, 1);});
+      if(m_closed)
+	return false;
+      m_slots.push_back(slot);
+      m_running++;
+    }
+    if(inline_cvt)
+      Convert(slot);
+    else
+      Executor::Instance().Submit([this, slot](){Convert(slot);});
+    return true;
+  }
+
+  void LCEventQueue::Convert(std::shared_ptr<Slot> slot){
+    bool converted = false;
+    std::exception_ptr err;
+    try{
+      converted = LCEventConverter::Convert(slot->item.ev, slot->item.lcev, m_conf);
+    }
+    catch(...){
+      err = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lk(m_mtx);
+    slot->item.converted = converted;
+    slot->err = err;
+    slot->done = true;
+    m_running--;
+    m_cv_pop.notify_all();
+  }
+
+  void LCEventQueue::Close(){
+    std::lock_guard<std::mutex> lk(m_mtx);
+    m_closed = true;
+    m_cv_push.notify_all();
+    m_cv_pop.notify_all();
+  }
+
+  bool LCEventQueue::Pop(Item &item){
+    std::shared_ptr<Slot> slot;
+    {
+      std::unique_lock<std::mutex> lk(m_mtx);
+      m_cv_pop.wait(lk, [this]{return (!m_slots.empty() && m_slots.front()->done)
+	    || (m_closed && m_slots.empty());});
+      if(m_slots.empty())
+	return false;
+      slot = m_slots.front();
+      m_slots.pop_front();
+    }
+    m_cv_push.notify_one();
+    if(slot->err)
+      std::rethrow_exception(slot->err);
+    item = std::move(slot->item);
+    return true;
+  }
+}
@@ -1,10 +1,15 @@
 #include "eudaq/FileNamer.hh"
 #include "eudaq/FileWriter.hh"
 #include "eudaq/Configuration.hh"
+#include "eudaq/Logger.hh"
 #include "eudaq/LCEventConverter.hh"
+#include "eudaq/LCEventQueue.hh"
 #include <ostream>
 #include <ctime>
 #include <iomanip>
+#include <thread>
+#include <mutex>
+#include <exception>
 
 
 #include "lcio.h"
@@ -23,24 +28,67 @@ namespace eudaq {
     auto dummy11 = Factory<FileWriter>::Register<LCFileWriter, std::string&&>(cstr2hash("slcio"));
   }
 
+  // Events are converted in parallel on the shared Executor and written in
+  // order by a thread of the writer, so that the caller only waits when
+  // more than EUDAQ_FW_LCIO_QUEUE events (default 64) are pending. With
+  // EUDAQ_FW_LCIO_QUEUE=0 every event is converted and written in WriteEvent.
+  // After an error the writer thread stops, so that the file does not go on
+  // with a gap; the error is thrown by the next WriteEvent, or logged when
+  // the writer is destroyed before that.
   class LCFileWriter : public FileWriter {
   public:
     LCFileWriter(const std::string &patt);
+    ~LCFileWriter() override;
     void WriteEvent(EventSPC ev) override;
   private:
+    void Write(EventSPC ev, LCEventSP lcevent);
+    void WriteLoop();
+    void ThrowWriteError();
+
     std::unique_ptr<lcio::LCWriter> m_lcwriter;
     std::string m_filepattern;
     uint32_t m_run_n;
+    std::unique_ptr<LCEventQueue> m_queue;
+    std::thread m_writer;
+    std::mutex m_mtx_err;
+    std::exception_ptr m_err;
   };
 
   LCFileWriter::LCFileWriter(const std::string &patt){
     m_filepattern = patt;
+    m_run_n = 0;
   }
 
-  void LCFileWriter::WriteEvent(EventSPC ev) {
+  LCFileWriter::~LCFileWriter(){
+    if(m_queue){
+      m_queue->Close();
+      if(m_writer.joinable())
+	m_writer.join();
+    }
+    if(m_err){
+      try{
+	std::rethrow_exception(m_err);
+      } catch (const std::exception &e) {
+	EUDAQ_ERROR(std::string("LCFileWriter: events were lost: ")+e.what());
+      } catch (...) {
+	EUDAQ_ERROR("LCFileWriter: events were lost: unknown error");
+      }
+    }
+    if(m_lcwriter){
+      try{
+	m_lcwriter->close();
+      } catch (const lcio::IOException &e) {
+	EUDAQ_ERROR(std::string("LCFileWriter: Fail to close LCIO file ")+e.what());
+      }
+    }
+  }
+
+  void LCFileWriter::Write(EventSPC ev, LCEventSP lcevent){
     uint32_t run_n = ev->GetRunN();
     if(!m_lcwriter || m_run_n != run_n){
       try {
+	if(m_lcwriter)
+	  m_lcwriter->close();
 	m_lcwriter.reset(lcio::LCFactory::getInstance()->createLCWriter());
 	std::time_t time_now = std::time(nullptr);
 	char time_buff[13];
@@ -51,13 +99,62 @@ namespace eudaq {
 			 lcio::LCIO::WRITE_NEW);
 	m_run_n = run_n;
       } catch (const lcio::IOException &e) {
+	m_lcwriter.reset();
 	EUDAQ_THROW(std::string("Fail to open LCIO file")+e.what());
       }
     }
     if(!m_lcwriter)
       EUDAQ_THROW("LCFileWriter: Attempt to write unopened file");
-    LCEventSP lcevent(new lcio::LCEventImpl);
-    LCEventConverter::Convert(ev, lcevent, GetConfiguration());
     m_lcwriter->writeEvent(lcevent.get());
   }
+
+  void LCFileWriter::WriteLoop(){
+    LCEventQueue::Item item;
+    for(;;){
+      try{
+	if(!m_queue->Pop(item))
+	  break;
+	Write(item.ev, item.lcev);
+      } catch (...) {
+	{
+	  std::lock_guard<std::mutex> lk(m_mtx_err);
+	  m_err = std::current_exception();
+	}
+	// the following events are dropped, WriteEvent sees the closed queue
+	m_queue->Close();
+	break;
+      }
+    }
+  }
+
+  void LCFileWriter::ThrowWriteError(){
+    std::exception_ptr err;
+    {
+      std::lock_guard<std::mutex> lk(m_mtx_err);
+      std::swap(err, m_err);
+    }
+    if(err)
+      std::rethrow_exception(err);
+  }
+
+  void LCFileWriter::WriteEvent(EventSPC ev) {
+    if(!m_queue){
+      auto conf = GetConfiguration();
+      size_t depth = conf ? conf->Get("EUDAQ_FW_LCIO_QUEUE", 64) : 64;
+      m_queue.reset(new LCEventQueue(depth, conf));
+      if(depth)
+	m_writer = std::thread(&LCFileWriter::WriteLoop, this);
+    }
+    ThrowWriteError();
+    if(!m_queue->GetDepth()){
+      LCEventSP lcevent(new lcio::LCEventImpl);
+      LCEventConverter::Convert(ev, lcevent, GetConfiguration());
+      Write(ev, lcevent);
+      return;
+    }
+    if(!m_queue->Push(ev)){
+      ThrowWriteError();
+      EUDAQ_THROW("LCFileWriter: writing stopped after an earlier error");
+    }
+  }
 }
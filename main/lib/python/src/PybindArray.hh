@@ -0,0 +1,38 @@
+#ifndef EUDAQ_INCLUDED_PybindArray
+#define EUDAQ_INCLUDED_PybindArray
+
+#include "pybind11/pybind11.h"
+#include "pybind11/numpy.h"
+
+#include <vector>
+
+namespace py = pybind11;
+
+// one-dimensional array over existing memory; the shape and strides are
+// spelt out, array_t(count, ptr, base) gives zero strides in this pybind11
+template <typename T>
+py::array_t<T> Array1D(size_t n, const T *ptr, py::handle base){
+  return py::array_t<T>(std::vector<size_t>{n}, std::vector<size_t>{sizeof(T)},
+			ptr, base);
+}
+
+// Read-only numpy view of a vector owned by base, no copy is made and the
+// view keeps base alive
+template <typename T>
+py::array_t<T> ArrayView(const std::vector<T> &v, py::handle base){
+  auto arr = Array1D(v.size(), v.data(), base);
+  arr.attr("setflags")(py::arg("write") = false);
+  return arr;
+}
+
+// numpy array that takes over the memory of a vector
+template <typename T>
+py::array_t<T> ArrayMove(std::vector<T> &&v){
+  auto owned = new std::vector<T>(std::move(v));
+  py::capsule owner(owned, [](void *p){
+      delete reinterpret_cast<std::vector<T>*>(p);
+    });
+  return Array1D(owned->size(), owned->data(), owner);
+}
+
+#endif // EUDAQ_INCLUDED_PybindArray
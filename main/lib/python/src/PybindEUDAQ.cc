@@ -3,6 +3,7 @@
 namespace py = pybind11;
 
 void init_pybind_event(py::module &);
+void init_pybind_standardevent(py::module &);
 void init_pybind_status(py::module &);
 void init_pybind_connection(py::module &);
 void init_pybind_producer(py::module &);
@@ -15,6 +16,7 @@ void init_pybind_filewriter(py::module &);
 PYBIND11_MODULE(pyeudaq, m){
   m.doc() = "EUDAQ library for Python";
   init_pybind_event(m);
+  init_pybind_standardevent(m);
   init_pybind_status(m);
   init_pybind_connection(m);
   init_pybind_producer(m);
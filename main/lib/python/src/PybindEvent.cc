@@ -1,5 +1,6 @@
 #include "pybind11/pybind11.h"
 #include "eudaq/Event.hh"
+#include "PybindArray.hh"
 
 namespace py = pybind11;
 
@@ -105,6 +106,13 @@ void  init_pybind_event(py::module &m){
   
   event_.def("GetBlock", &eudaq::Event::GetBlock,
 	     "Get block", py::arg("n"));
+  event_.def("GetBlockView",
+	     [](py::object self, uint32_t n){
+	       auto &ev = self.cast<const eudaq::Event&>();
+	       return ArrayView(ev.GetBlockRef(n), self);
+	     },
+	     "Get block as a read-only uint8 numpy array without copying",
+	     py::arg("n"));
   event_.def("GetNumBlock", &eudaq::Event::GetNumBlock);
   event_.def("GetNumBlockList", &eudaq::Event::GetBlockNumList);
   event_.def("AddBlock",
@@ -1,5 +1,8 @@
 #include "pybind11/pybind11.h"
 #include "eudaq/FileReader.hh"
+#include "eudaq/StandardEvent.hh"
+#include "eudaq/StdEventConverter.hh"
+#include "PybindArray.hh"
 
 namespace py = pybind11;
 
@@ -14,9 +17,108 @@ class PyFileReader : public eudaq::FileReader {
   }
 };
 
+namespace{
+  // up to n events, read without holding the GIL
+  std::vector<eudaq::EventSPC> ReadEvents(eudaq::FileReader &reader, size_t n){
+    std::vector<eudaq::EventSPC> evs;
+    evs.reserve(n);
+    py::gil_scoped_release release;
+    while(evs.size() < n){
+      auto ev = reader.GetNextEvent();
+      if(!ev)
+	break;
+      evs.push_back(ev);
+    }
+    return evs;
+  }
+
+  struct RecordBatch {
+    std::vector<uint32_t> event_n, trigger_n, run_n, device_n, type, flag;
+    std::vector<uint64_t> ts_begin, ts_end;
+    std::vector<uint32_t> hit_event, hit_plane;
+    std::vector<double> hit_x, hit_y, hit_pix;
+
+    void AddEvent(const eudaq::Event &ev){
+      event_n.push_back(ev.GetEventN());
+      trigger_n.push_back(ev.GetTriggerN());
+      run_n.push_back(ev.GetRunN());
+      device_n.push_back(ev.GetDeviceN());
+      type.push_back(ev.GetType());
+      flag.push_back(ev.GetFlag());
+      ts_begin.push_back(ev.GetTimestampBegin());
+      ts_end.push_back(ev.GetTimestampEnd());
+    }
+
+    void AddHits(uint32_t index, const eudaq::StandardEvent &ev){
+      for(size_t i = 0; i < ev.NumPlanes(); i++){
+	auto &plane = ev.GetPlane(i);
+	auto &x = plane.XVector();
+	auto &y = plane.YVector();
+	auto &pix = plane.PixVector();
+	hit_event.insert(hit_event.end(), x.size(), index);
+	hit_plane.insert(hit_plane.end(), x.size(), plane.ID());
+	hit_x.insert(hit_x.end(), x.begin(), x.end());
+	hit_y.insert(hit_y.end(), y.begin(), y.end());
+	hit_pix.insert(hit_pix.end(), pix.begin(), pix.end());
+      }
+    }
+
+    py::dict ToDict(bool hits){
+      py::dict d;
+      d["EventN"] = ArrayMove(std::move(event_n));
+      d["TriggerN"] = ArrayMove(std::move(trigger_n));
+      d["RunN"] = ArrayMove(std::move(run_n));
+      d["DeviceN"] = ArrayMove(std::move(device_n));
+      d["Type"] = ArrayMove(std::move(type));
+      d["Flag"] = ArrayMove(std::move(flag));
+      d["TimestampBegin"] = ArrayMove(std::move(ts_begin));
+      d["TimestampEnd"] = ArrayMove(std::move(ts_end));
+      if(hits){
+	d["HitEvent"] = ArrayMove(std::move(hit_event));
+	d["HitPlane"] = ArrayMove(std::move(hit_plane));
+	d["HitX"] = ArrayMove(std::move(hit_x));
+	d["HitY"] = ArrayMove(std::move(hit_y));
+	d["HitPix"] = ArrayMove(std::move(hit_pix));
+      }
+      return d;
+    }
+  };
+}
+
 void init_pybind_filereader(py::module &m){
   py::class_<eudaq::FileReader, PyFileReader, std::shared_ptr<eudaq::FileReader>>
     filereader_(m, "FileReader");
   filereader_.def(py::init(&eudaq::FileReader::Make));
   filereader_.def("GetNextEvent", &eudaq::FileReader::GetNextEvent);
+  filereader_.def("GetNextEvents",
+		  [](eudaq::FileReader &reader, size_t n){
+		    py::list evs;
+		    for(auto &ev: ReadEvents(reader, n))
+		      evs.append(py::cast(ev));
+		    return evs;
+		  },
+		  "Read up to n events, an empty list at the end of the file",
+		  py::arg("n"));
+  filereader_.def("ReadBatch",
+		  [](eudaq::FileReader &reader, size_t n, bool standard){
+		    auto evs = ReadEvents(reader, n);
+		    RecordBatch batch;
+		    {
+		      py::gil_scoped_release release;
+		      for(auto &ev: evs){
+			if(standard){
+			  auto stdev = eudaq::StandardEvent::MakeShared();
+			  if(!eudaq::StdEventConverter::Convert(ev, stdev, nullptr))
+			    continue;
+			  batch.AddHits(batch.event_n.size(), *stdev);
+			}
+			batch.AddEvent(*ev);
+		      }
+		    }
+		    return batch.ToDict(standard);
+		  },
+		  "Read up to n events into a dict of numpy columns, one entry per "
+		  "event; with standard=True the events are converted and their "
+		  "hits are added as Hit* columns, HitEvent indexing the events",
+		  py::arg("n"), py::arg("standard") = false);
 }
@@ -0,0 +1,78 @@
+#include "pybind11/pybind11.h"
+#include "eudaq/StandardEvent.hh"
+#include "eudaq/StdEventConverter.hh"
+#include "PybindArray.hh"
+
+namespace py = pybind11;
+
+void init_pybind_standardevent(py::module &m){
+  py::class_<eudaq::StandardPlane> plane_(m, "StandardPlane");
+  plane_.def("ID", &eudaq::StandardPlane::ID);
+  plane_.def("Type", &eudaq::StandardPlane::Type);
+  plane_.def("Sensor", &eudaq::StandardPlane::Sensor);
+  plane_.def("XSize", &eudaq::StandardPlane::XSize);
+  plane_.def("YSize", &eudaq::StandardPlane::YSize);
+  plane_.def("NumFrames", &eudaq::StandardPlane::NumFrames);
+  plane_.def("HitPixels",
+	     (uint32_t (eudaq::StandardPlane::*)() const)
+	     &eudaq::StandardPlane::HitPixels);
+  plane_.def("HitPixels",
+	     (uint32_t (eudaq::StandardPlane::*)(uint32_t) const)
+	     &eudaq::StandardPlane::HitPixels,
+	     "Number of hits in a frame", py::arg("frame"));
+  // hit arrays as read-only numpy views into the plane, which stays alive
+  // as long as a view does
+  plane_.def("XArray",
+	     [](py::object self){
+	       return ArrayView(self.cast<const eudaq::StandardPlane&>().XVector(), self);
+	     });
+  plane_.def("XArray",
+	     [](py::object self, uint32_t frame){
+	       return ArrayView(self.cast<const eudaq::StandardPlane&>().XVector(frame), self);
+	     },
+	     "Hit columns of a frame", py::arg("frame"));
+  plane_.def("YArray",
+	     [](py::object self){
+	       return ArrayView(self.cast<const eudaq::StandardPlane&>().YVector(), self);
+	     });
+  plane_.def("YArray",
+	     [](py::object self, uint32_t frame){
+	       return ArrayView(self.cast<const eudaq::StandardPlane&>().YVector(frame), self);
+	     },
+	     "Hit rows of a frame", py::arg("frame"));
+  plane_.def("PixArray",
+	     [](py::object self){
+	       return ArrayView(self.cast<const eudaq::StandardPlane&>().PixVector(), self);
+	     });
+  plane_.def("PixArray",
+	     [](py::object self, uint32_t frame){
+	       return ArrayView(self.cast<const eudaq::StandardPlane&>().PixVector(frame), self);
+	     },
+	     "Hit values of a frame", py::arg("frame"));
+
+  py::class_<eudaq::StandardEvent, eudaq::Event, eudaq::StdEventSP>
+    stdevent_(m, "StandardEvent");
+  stdevent_.def(py::init(&eudaq::StandardEvent::MakeShared));
+  stdevent_.def("NumPlanes", &eudaq::StandardEvent::NumPlanes);
+  stdevent_.def("GetPlane",
+		(eudaq::StandardPlane& (eudaq::StandardEvent::*)(size_t))
+		&eudaq::StandardEvent::GetPlane,
+		"Get plane", py::arg("i"),
+		py::return_value_policy::reference_internal);
+  stdevent_.def("GetTimeBegin", &eudaq::StandardEvent::GetTimeBegin);
+  stdevent_.def("GetTimeEnd", &eudaq::StandardEvent::GetTimeEnd);
+  stdevent_.def("GetDetectorType", &eudaq::StandardEvent::GetDetectorType);
+
+  m.def("ConvertToStandard",
+	[](eudaq::EventSPC ev) -> eudaq::StdEventSP {
+	  auto stdev = eudaq::StandardEvent::MakeShared();
+	  bool ok;
+	  {
+	    py::gil_scoped_release release;
+	    ok = eudaq::StdEventConverter::Convert(ev, stdev, nullptr);
+	  }
+	  return ok ? stdev : nullptr;
+	},
+	"Convert an event to a StandardEvent, None if there is no converter",
+	py::arg("ev"));
+}
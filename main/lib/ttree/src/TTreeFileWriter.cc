@@ -1,16 +1,17 @@
 #include "eudaq/FileNamer.hh"
 #include "eudaq/FileWriter.hh"
 #include "eudaq/Configuration.hh"
-#include "eudaq/TTreeEventConverter.hh"
+#include "eudaq/StandardEvent.hh"
+#include "eudaq/StdEventConverter.hh"
 #include <ostream>
 #include <ctime>
 #include <iomanip>
 #include <vector>
+#include <algorithm>
 
 
 #include "TFile.h"
 #include "TTree.h"
-#include "TRandom.h"
 #include "TString.h"
 
 
@@ -21,57 +22,181 @@ namespace eudaq {
     auto dummy11 = Factory<FileWriter>::Register<TTreeFileWriter, std::string&&>(cstr2hash("root"));
   }
 
+  // One file per run with two trees, both filled from buffers that are
+  // bound to their branches once when the file is opened:
+  //   EventTree: one entry per event with the event header
+  //   HitTree:   one entry per plane of the StandardEvent, with the hits
+  //              as arrays of length nhits
+  // Configuration:
+  //   EUDAQ_FW_ROOT_BASKET       basket size in bytes (32000)
+  //   EUDAQ_FW_ROOT_COMPRESSION  ROOT compression setting, e.g. 101 or 505
+  //   EUDAQ_FW_ROOT_AUTOFLUSH    TTree::SetAutoFlush, >0 entries, <0 bytes
   class TTreeFileWriter : public FileWriter {
   public:
     TTreeFileWriter(const std::string &patt);
-    ~TTreeFileWriter();
+    ~TTreeFileWriter() override;
     void WriteEvent(EventSPC ev) override;
+    uint64_t FileBytes() const override;
   private:
-    std::unique_ptr<TFile> m_ttreewriter;
+    void Open(uint32_t run_n);
+    void Close();
+    void FillPlanes(const StandardEvent &stdev);
+    void ReserveHits(size_t n);
+
     std::string m_filepattern;
     uint32_t m_run_n;
-    TFile *m_tfile; // book the pointer to a file (to store the otuput)
-    TTreeEventSP ttree;
-    };
-
-  TTreeFileWriter::TTreeFileWriter(const std::string &patt){
-    m_filepattern = patt;    
-	std::time_t time_now = std::time(nullptr);
-	char time_buff[13];
-	time_buff[12] = 0;
-	std::strftime(time_buff, sizeof(time_buff), "%y%m%d%H%M%S", std::localtime(&time_now));
-	std::string time_str(time_buff);
-	std::string foutput(FileNamer(m_filepattern).Set('X', ".root").Set('R', m_run_n).Set('D', time_str));
-	m_tfile = new TFile(foutput.c_str(), "RECREATE");
-	EUDAQ_INFO("Preparing the outputfile: " + foutput);
-	ttree.reset(new TTree("EventTree","Converted from .raw"));
-	TBranch* run   = ttree->Branch("run_n",0, "run_n/i");
-	TBranch* event = ttree->Branch("event_n",0, "event_n/i");
-	TBranch* eventflag = ttree->Branch("event_flag",0, "eflag/i");
-	TBranch* device_n = ttree->Branch("device_n",0, "devnum/i");	
-	TBranch* trigger_n = ttree->Branch("trigger_n",0, "trign/i");
-	TBranch* tsb = ttree->Branch("timestampbegin",0, "tsb/l");
-	TBranch* tse = ttree->Branch("timestampend",0, "tse/l");
+    std::unique_ptr<TFile> m_tfile;
+    TTree *m_evtree; // owned by m_tfile
+    TTree *m_hittree; // owned by m_tfile
+
+    UInt_t m_run, m_event, m_flag, m_device, m_trigger, m_planes;
+    ULong64_t m_tsb, m_tse;
+
+    UInt_t m_plane_id, m_nhits;
+    std::vector<Double_t> m_x, m_y, m_value;
+    std::vector<ULong64_t> m_ts;
+  };
+
+  TTreeFileWriter::TTreeFileWriter(const std::string &patt)
+    :m_filepattern(patt), m_run_n(0), m_evtree(nullptr), m_hittree(nullptr),
+     m_run(0), m_event(0), m_flag(0), m_device(0), m_trigger(0), m_planes(0),
+     m_tsb(0), m_tse(0), m_plane_id(0), m_nhits(0){
   }
-  TTreeFileWriter::~TTreeFileWriter () {
-    m_tfile->Write();    
+
+  TTreeFileWriter::~TTreeFileWriter(){
+    Close();
   }
-  
+
+  void TTreeFileWriter::Open(uint32_t run_n){
+    Close();
+    auto conf = GetConfiguration();
+    Int_t basket = 32000;
+    if(conf)
+      basket = conf->Get("EUDAQ_FW_ROOT_BASKET", basket);
+    std::time_t time_now = std::time(nullptr);
+    char time_buff[13];
+    time_buff[12] = 0;
+    std::strftime(time_buff, sizeof(time_buff), "%y%m%d%H%M%S", std::localtime(&time_now));
+    std::string time_str(time_buff);
+    std::string foutput(FileNamer(m_filepattern).Set('X', ".root").Set('R', run_n).Set('D', time_str));
+    m_tfile.reset(TFile::Open(foutput.c_str(), "RECREATE"));
+    if(!m_tfile || m_tfile->IsZombie()){
+      m_tfile.reset();
+      EUDAQ_THROW("TTreeFileWriter: Fail to open ROOT file " + foutput);
+    }
+    EUDAQ_INFO("Preparing the outputfile: " + foutput);
+    if(conf && conf->Has("EUDAQ_FW_ROOT_COMPRESSION"))
+      m_tfile->SetCompressionSettings(conf->Get("EUDAQ_FW_ROOT_COMPRESSION", 101));
+    m_tfile->cd();
+
+    m_evtree = new TTree("EventTree", "Converted from .raw");
+    m_evtree->Branch("run_n", &m_run, "run_n/i", basket);
+    m_evtree->Branch("event_n", &m_event, "event_n/i", basket);
+    m_evtree->Branch("event_flag", &m_flag, "event_flag/i", basket);
+    m_evtree->Branch("device_n", &m_device, "device_n/i", basket);
+    m_evtree->Branch("trigger_n", &m_trigger, "trigger_n/i", basket);
+    m_evtree->Branch("timestampbegin", &m_tsb, "timestampbegin/l", basket);
+    m_evtree->Branch("timestampend", &m_tse, "timestampend/l", basket);
+    m_evtree->Branch("planes", &m_planes, "planes/i", basket);
+
+    ReserveHits(1024);
+    m_hittree = new TTree("HitTree", "Hits of the StandardEvent planes");
+    m_hittree->Branch("run_n", &m_run, "run_n/i", basket);
+    m_hittree->Branch("event_n", &m_event, "event_n/i", basket);
+    m_hittree->Branch("trigger_n", &m_trigger, "trigger_n/i", basket);
+    m_hittree->Branch("plane_id", &m_plane_id, "plane_id/i", basket);
+    m_hittree->Branch("nhits", &m_nhits, "nhits/i", basket);
+    m_hittree->Branch("x", m_x.data(), "x[nhits]/D", basket);
+    m_hittree->Branch("y", m_y.data(), "y[nhits]/D", basket);
+    m_hittree->Branch("value", m_value.data(), "value[nhits]/D", basket);
+    m_hittree->Branch("timestamp", m_ts.data(), "timestamp[nhits]/l", basket);
+
+    if(conf && conf->Has("EUDAQ_FW_ROOT_AUTOFLUSH")){
+      Long64_t autoflush = conf->Get("EUDAQ_FW_ROOT_AUTOFLUSH", -30000000ll);
+      m_evtree->SetAutoFlush(autoflush);
+      m_hittree->SetAutoFlush(autoflush);
+    }
+    m_run_n = run_n;
+  }
+
+  void TTreeFileWriter::Close(){
+    if(!m_tfile)
+      return;
+    m_tfile->cd();
+    m_evtree->Write("", TObject::kOverwrite);
+    m_hittree->Write("", TObject::kOverwrite);
+    m_tfile->Close();
+    m_tfile.reset();
+    m_evtree = nullptr;
+    m_hittree = nullptr;
+  }
+
+  void TTreeFileWriter::ReserveHits(size_t n){
+    if(n <= m_x.size())
+      return;
+    n = std::max(n, 2 * m_x.size());
+    m_x.resize(n);
+    m_y.resize(n);
+    m_value.resize(n);
+    m_ts.resize(n);
+    // the arrays moved, point the branches to their new place
+    if(m_hittree){
+      m_hittree->SetBranchAddress("x", m_x.data());
+      m_hittree->SetBranchAddress("y", m_y.data());
+      m_hittree->SetBranchAddress("value", m_value.data());
+      m_hittree->SetBranchAddress("timestamp", m_ts.data());
+    }
+  }
+
+  void TTreeFileWriter::FillPlanes(const StandardEvent &stdev){
+    for(size_t i = 0; i < stdev.NumPlanes(); i++){
+      auto &plane = stdev.GetPlane(i);
+      auto &x = plane.XVector();
+      auto &y = plane.YVector();
+      auto &pix = plane.PixVector();
+      size_t n = x.size();
+      ReserveHits(n);
+      std::copy(x.begin(), x.end(), m_x.begin());
+      std::copy(y.begin(), y.end(), m_y.begin());
+      std::copy(pix.begin(), pix.end(), m_value.begin());
+      for(size_t k = 0; k < n; k++)
+	m_ts[k] = plane.GetTimestamp(k);
+      m_plane_id = plane.ID();
+      m_nhits = n;
+      m_hittree->Fill();
+    }
+  }
+
   void TTreeFileWriter::WriteEvent(EventSPC ev) {
     uint32_t run_n = ev->GetRunN();
-    if(!m_ttreewriter || m_run_n != run_n){
-      try{
-	m_ttreewriter.reset(m_tfile);
-	m_run_n = run_n;
-      } catch(const Exception &e){
-      EUDAQ_THROW(std::string("Fail to open ROOT file")+e.what());
+    if(!m_tfile || m_run_n != run_n)
+      Open(run_n);
+    if(ev->IsFlagFake())
+      return;
+
+    m_run = run_n;
+    m_event = ev->GetEventN();
+    m_flag = ev->GetFlag();
+    m_device = ev->GetDeviceN();
+    m_trigger = ev->GetTriggerN();
+    m_tsb = ev->GetTimestampBegin();
+    m_tse = ev->GetTimestampEnd();
+    m_planes = 0;
+
+    auto stdev = std::dynamic_pointer_cast<const StandardEvent>(ev);
+    if(!stdev){
+      auto conv = StandardEvent::MakeShared();
+      if(StdEventConverter::Convert(ev, conv, GetConfiguration()))
+	stdev = conv;
     }
+    if(stdev){
+      m_planes = stdev->NumPlanes();
+      FillPlanes(*stdev);
     }
-    if(!m_ttreewriter)
-      EUDAQ_THROW("TTreeFileWriter: Attempt to write unopened file");
-    uint32_t event_n = ev->GetEventN();
-    TTreeEventConverter::Convert(ev, ttree, GetConfiguration());
+    m_evtree->Fill();
   }
 
-
+  uint64_t TTreeFileWriter::FileBytes() const {
+    return m_tfile ? m_tfile->GetBytesWritten() : 0;
+  }
 }
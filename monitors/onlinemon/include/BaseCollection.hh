@@ -68,6 +68,11 @@ class BaseCollection {
    * the new data*/
   virtual void Fill(const SimpleStandardEvent &simpev) = 0;
 
+  //!Flush
+  /*!This moves data accumulated outside of the histograms into them. It is
+   * called once per GUI update, the default does nothing*/
+  virtual void Flush() {}
+
   //!Reset
   /*!This resets all the histograms ready for a new run*/
   virtual void Reset() = 0;
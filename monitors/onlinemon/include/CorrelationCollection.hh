@@ -17,6 +17,8 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <unordered_map>
+#include <cstdint>
 
 #include "CorrelationHistos.hh"
 #include "BaseCollection.hh"
@@ -38,6 +40,41 @@ struct SortClustersByXY {
   }
 };
 
+//!Cluster Grid Class
+/*!
+  Clusters of one plane bucketed in square cells as wide as the correlation
+  window, so a window lookup only visits the 3x3 cells around a position
+  instead of every cluster of the plane.
+ */
+class ClusterGrid {
+public:
+  ClusterGrid() : _width(0) {}
+  //! clusters must stay sorted as they are, indices refer to them
+  void Build(const std::vector<SimpleStandardCluster> &clusters,
+             const int width);
+  //! highest index of an unused cluster closer than the width, or -1
+  int Find(const int x, const int y) const;
+  bool isUsed(const unsigned int i) const { return _used[i]; }
+  void setUsed(const unsigned int i) { _used[i] = true; }
+
+private:
+  static int floorDiv(const int a, const int b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+  }
+  static uint64_t key(const int cx, const int cy) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+           static_cast<uint32_t>(cy);
+  }
+  uint64_t cell(const int x, const int y) const {
+    return key(floorDiv(x, _width), floorDiv(y, _width));
+  }
+  int _width;
+  std::vector<int> _x;
+  std::vector<int> _y;
+  std::vector<bool> _used;
+  std::unordered_map<uint64_t, std::vector<unsigned int>> _cells;
+};
+
 //!Correlation Collection Class
 /*!
   This inherits from the BaseCollection class. It is used as part of the online
@@ -51,8 +88,9 @@ class CorrelationCollection : public BaseCollection {
   bool checkCorrelations(const SimpleStandardCluster &cluster1,
                          const SimpleStandardCluster &cluster2,
                          const bool all_mimosa);
-  void fillHistograms(vector<vector<pair<int, SimpleStandardCluster>>> tracks,
-                      const SimpleStandardEvent &simpEv);
+  void fillHistograms(
+      const vector<vector<pair<int, SimpleStandardCluster>>> &tracks,
+      const SimpleStandardEvent &simpEv);
   void fillHistograms(const SimpleStandardPlane &p1,
                       const SimpleStandardPlane &p2,
 		      const SimpleStandardEvent &simpEv);
@@ -87,6 +125,16 @@ class CorrelationCollection : public BaseCollection {
   unsigned getWindowWidthForCorrelation() { return windowWidthForCorrelation; }
 
 private:
+  int updateSkippedPlanes(const int nPlanes);
+  void registerPlane(const SimpleStandardPlane &simpPlane,
+                     const int planeIndex);
+  CorrelationHistos *findCorrelationHistos(const SimpleStandardPlane &p1,
+                                           const SimpleStandardPlane &p2);
+  // scratch space kept between events
+  vector<vector<SimpleStandardCluster>> _trackClusters;
+  vector<ClusterGrid> _trackGrids;
+  vector<const SimpleStandardCluster *> _aClusters;
+  vector<const SimpleStandardCluster *> _bClusters;
   vector<bool> skip_this_plane; // a array of booleans, initialized with values
                                 // of selected_planes_to_skip on the first call
   bool correlateAllPlanes;
@@ -96,6 +144,7 @@ class CorrelationCollection : public BaseCollection {
 };
 
 #ifdef __CINT__
+#pragma link C++ class ClusterGrid - ;
 #pragma link C++ class CorrelationCollection - ;
 #endif
 
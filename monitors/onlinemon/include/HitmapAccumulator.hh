@@ -0,0 +1,82 @@
+#ifndef HITMAPACCUMULATOR_HH_
+#define HITMAPACCUMULATOR_HH_
+
+#include <atomic>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <cstdint>
+
+//! Dense counter for one integer valued quantity
+/*! Values inside [min, max) are counted in an array of atomics, everything
+ * else goes into a small map behind a mutex. Fill is safe from any thread.
+ */
+class DenseCounter {
+public:
+  DenseCounter(int min, int max);
+  void Fill(int value);
+  //! append all non-zero (value, count) pairs to counts and zero them
+  void Take(std::vector<std::pair<int, uint32_t>> &counts);
+  void Reset();
+
+private:
+  int _min;
+  std::vector<std::atomic<uint32_t>> _counts;
+  std::mutex _mu;
+  std::map<int, uint32_t> _outside;
+};
+
+//! Per-hit histogram contents of one plane, kept outside of ROOT
+/*! Raw hitmap, its projections, the Mimosa26 section counts and the
+ * TOT/LVL1 distributions are counted here and moved into the TH* objects
+ * by HitmapHistos::Flush. The hot pixel mask is a bitmap, so masking a
+ * hit costs one load instead of a TH2::GetBinContent.
+ */
+class HitmapAccumulator {
+public:
+  HitmapAccumulator(int maxX, int maxY, unsigned int nsections,
+                    int section_boundary);
+  //! count a hit in hitmap and projections, hits on hot pixels are dropped
+  void FillHit(int x, int y, bool sections);
+  void FillTOT(int tot) { _tot.Fill(tot); }
+  void FillLVL1(int lvl1) { _lvl1.Fill(lvl1); }
+
+  bool IsHot(int x, int y) const;
+  void SetHot(int x, int y);
+  void ClearHot();
+
+  //! (x, y, count) of the hitmap, zeroed afterwards
+  void TakeHitmap(std::vector<std::pair<std::pair<int, int>, uint32_t>> &counts);
+  void TakeX(std::vector<std::pair<int, uint32_t>> &counts) { _x.Take(counts); }
+  void TakeY(std::vector<std::pair<int, uint32_t>> &counts) { _y.Take(counts); }
+  void TakeSections(std::vector<std::pair<int, uint32_t>> &counts) {
+    _sections.Take(counts);
+  }
+  void TakeTOT(std::vector<std::pair<int, uint32_t>> &counts) { _tot.Take(counts); }
+  void TakeLVL1(std::vector<std::pair<int, uint32_t>> &counts) { _lvl1.Take(counts); }
+
+  //! clear all counts and the hot pixel mask
+  void Reset();
+
+private:
+  int _maxX;
+  int _maxY;
+  int _section_boundary;
+  std::vector<std::atomic<uint32_t>> _hitmap;
+  std::vector<std::atomic<uint64_t>> _hot;
+  DenseCounter _x;
+  DenseCounter _y;
+  DenseCounter _sections;
+  DenseCounter _tot;
+  DenseCounter _lvl1;
+  std::mutex _mu;
+  std::map<std::pair<int, int>, uint32_t> _outside; // hits outside the sensor
+};
+
+#ifdef __CINT__
+#pragma link C++ class DenseCounter - ;
+#pragma link C++ class HitmapAccumulator - ;
+#endif
+
+#endif /* HITMAPACCUMULATOR_HH_ */
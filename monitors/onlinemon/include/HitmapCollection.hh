@@ -43,6 +43,7 @@ class HitmapCollection : public BaseCollection {
   void Fill(const SimpleStandardEvent &simpev);
   HitmapHistos *getHitmapHistos(std::string sensor, int id);
   void Reset();
+  virtual void Flush();
   virtual void Write(TFile *file);
   virtual void Calculate(const unsigned int currentEventNumber);
 };
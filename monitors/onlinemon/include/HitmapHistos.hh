@@ -12,8 +12,12 @@
 #include <TFile.h>
 
 #include <map>
+#include <vector>
+#include <utility>
 
 #include "SimpleStandardEvent.hh"
+#include "HitmapAccumulator.hh"
+#include "OccupancyEstimator.hh"
 
 using namespace std;
 
@@ -52,13 +56,19 @@ class HitmapHistos {
 
 public:
   HitmapHistos(SimpleStandardPlane p, RootMonitor *mon);
+  ~HitmapHistos();
+  HitmapHistos(const HitmapHistos &) = delete;
+  HitmapHistos &operator=(const HitmapHistos &) = delete;
 
   void Fill(const SimpleStandardHit &hit);
   void Fill(const SimpleStandardPlane &plane);
   void Fill(const SimpleStandardCluster &cluster);
+  // move the accumulated per-hit counts into the histograms
+  void Flush();
   void Reset();
 
-  void Calculate(const int currentEventNum);
+  // search for hot pixels, at most every HotPixelUpdate events of this plane
+  void Calculate();
   void Write();
 
   TH2I *getHitmapHisto() { return _hitmap; }
@@ -97,16 +107,27 @@ class HitmapHistos {
     return _nHotPixels_section[section];
   }
   TH1I *getNHotPixelsHisto() { return _nHotPixels; }
+  // the HotPixelTopK hottest pixels of the last search, hottest first
+  const std::vector<OccupancyEstimator::Pixel> &getTopHotPixels() const {
+    return _topHotPixels;
+  }
   void setRootMonitor(RootMonitor *mon) { _mon = mon; }
 
 private:
-  int **plane_map_array; // store an array representing the map
-  int zero_plane_array(); // fill array with zeros;
   int SetHistoAxisLabelx(TH1 *histo, string xlabel);
   int SetHistoAxisLabely(TH1 *histo, string ylabel);
   int SetHistoAxisLabels(TH1 *histo, string xlabel, string ylabel);
-  int filling_counter; // we don't need occupancy to be refreshed for every
-                       // single event
+  // occupancy of the hit pixels, replaces a dense per-plane array
+  OccupancyEstimator *_occ;
+  uint64_t _lastCalculate; // events of this plane at the last search
+  std::vector<OccupancyEstimator::Pixel> _hotPixels;
+  std::vector<OccupancyEstimator::Pixel> _topHotPixels;
+  std::vector<double> _occupancies;
+  // per-hit counts, flushed into the histograms on each GUI update
+  HitmapAccumulator *_acc;
+  std::vector<std::pair<int, uint32_t>> _flush_counts;
+  std::vector<std::pair<std::pair<int, int>, uint32_t>> _flush_hitmap;
+  void FlushCounts(TH1 *histo);
 
   RootMonitor *_mon;
   unsigned int mimosa26_max_section;
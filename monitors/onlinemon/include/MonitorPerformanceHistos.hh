@@ -9,10 +9,12 @@
 #define MONITORPERFORMANCEHISTOS_HH_
 
 #include <TH1I.h>
+#include <TH1D.h>
 #include <TFile.h>
 
 #include <map>
 #include "SimpleStandardEvent.hh"
+#include "eudaq/LatencyHistogram.hh"
 #include <mutex>
 
 using namespace std;
@@ -24,8 +26,17 @@ class MonitorPerformanceHistos {
   TH1I *_FillTimeHisto;
   TH1I *_ClusteringTimeHisto;
   TH1I *_CorrelationTimeHisto;
+  // time between the hops of the event, log binned, in seconds
+  TH1D *_ProducerToCollectorHisto;
+  TH1D *_CollectorHisto;
+  TH1D *_CollectorToMonitorHisto;
+  TH1D *_MonitorHisto;
+  TH1D *_EndToEndHisto;
+  // producer to histogram fill, for the status tags
+  eudaq::LatencyHistogram _endToEnd;
 
   std::mutex m_mu;
+  TH1D *makeLatencyHisto(const char *name);
   
 public:
   MonitorPerformanceHistos();
@@ -37,6 +48,12 @@ class MonitorPerformanceHistos {
   TH1I *getFillTimeHisto() { return _FillTimeHisto; }
   TH1I *getClusteringTimeHisto() { return _ClusteringTimeHisto; }
   TH1I *getCorrelationTimeHisto() { return _CorrelationTimeHisto; }
+  TH1D *getProducerToCollectorHisto() { return _ProducerToCollectorHisto; }
+  TH1D *getCollectorHisto() { return _CollectorHisto; }
+  TH1D *getCollectorToMonitorHisto() { return _CollectorToMonitorHisto; }
+  TH1D *getMonitorHisto() { return _MonitorHisto; }
+  TH1D *getEndToEndHisto() { return _EndToEndHisto; }
+  const eudaq::LatencyHistogram &getEndToEnd() const { return _endToEnd; }
   std::mutex* getMutex(){return &m_mu;};
   
 };
@@ -0,0 +1,60 @@
+#ifndef OCCUPANCYESTIMATOR_HH_
+#define OCCUPANCYESTIMATOR_HH_
+
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//! Running per-pixel hit frequency of one plane
+/*! Only pixels that have been hit are stored, and a hit touches only its own
+ * entry. With a decay length of N events, older events are weighted down
+ * by exp(-age/N); instead of scaling every entry per event, the weight of
+ * new hits grows and the entries are renormalised once in a while. A decay
+ * of 0 gives the plain hit count divided by the number of events.
+ * The number of stored pixels is bounded, Update drops the least active
+ * ones when there are too many.
+ */
+class OccupancyEstimator {
+public:
+  struct Pixel {
+    int x;
+    int y;
+    double occupancy;
+  };
+
+  OccupancyEstimator(int maxX, int maxY);
+  //! decay length in events, 0 disables the decay
+  void setDecay(double events);
+  //! maximum number of pixels kept
+  void setCapacity(size_t n);
+  //! count one more event of this plane, call before filling its hits
+  void AddEvent();
+  void Fill(int x, int y);
+  //! number of events since Reset, not weighted
+  uint64_t getEvents() const { return _events; }
+  double getOccupancy(int x, int y) const;
+  //! all pixels above cut, the first k of them sorted most active first;
+  //! occupancies of all stored pixels go to all if it is not NULL
+  void Update(double cut, size_t k, std::vector<Pixel> &hot,
+              std::vector<double> *all = NULL);
+  void Reset();
+
+private:
+  void Renormalise();
+  int _maxX;
+  int _maxY;
+  double _growth;  // weight factor from one event to the next
+  double _weight;  // weight of a hit in the current event
+  double _wsum;    // sum of the event weights
+  uint64_t _events;
+  size_t _capacity;
+  std::unordered_map<uint32_t, double> _counts; // x * maxY + y -> weighted hits
+  std::vector<std::pair<double, uint32_t>> _scratch;
+};
+
+#ifdef __CINT__
+#pragma link C++ class OccupancyEstimator - ;
+#endif
+
+#endif /* OCCUPANCYESTIMATOR_HH_ */
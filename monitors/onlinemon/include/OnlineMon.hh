@@ -32,6 +32,13 @@
 // STL includes
 #include <string>
 #include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
 
 using namespace std;
 
@@ -43,13 +50,15 @@ class RootMonitor : public eudaq::Monitor{
 public:
   RootMonitor(const std::string &runcontrol, 
 	      int x, int y, int w, int h,
-              const std::string &conffile = "", const std::string &monname = "");
+              const std::string &conffile = "", const std::string &monname = "",
+              const bool headless = false);
   ~RootMonitor() override;
   void DoConfigure() override;
   void DoStartRun() override;
   void DoStopRun() override;
   void DoTerminate() override;
   void DoReceive(eudaq::EventSP) override;
+  void DoStatus() override;
   
   void autoReset(const bool reset);
   
@@ -60,7 +69,15 @@ class RootMonitor : public eudaq::Monitor{
   void setCorr_planes(const unsigned c_p);
   void setUseTrack_corr(const bool t_c);
   void setTracksPerEvent(const unsigned int tracks);
+  void setThreads(const unsigned int n);
+  // events read from a file are reduced here, online the DataCollector samples them
+  void setOffline(const bool offline);
+  // write ROOT and JSON snapshots to dir every interval seconds, 0 disables
+  void setDump(const unsigned int interval, const std::string &dir);
+  void DumpIfDue();
   void SetSnapShotDir(string s);
+  // fill the collections with everything analysed so far, called by the GUI timer
+  void FlushFillBuffers();
 
   bool getUseTrack_corr() const;
   unsigned int getTracksPerEvent() const;
@@ -68,27 +85,64 @@ class RootMonitor : public eudaq::Monitor{
   OnlineMonWindow *getOnlineMon() const;
   OnlineMonConfiguration mon_configdata; // FIXME
 private:
+  // events analysed by one worker, waiting to be filled; a worker with a
+  // full buffer waits on cv until the GUI timer drained it or stop is set
+  struct FillBuffer {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<SimpleStandardEvent> events;
+    bool stop = false;
+  };
+  void StartWorkers();
+  void StopWorkers();
+  void WaitWorkersIdle();
+  void WorkerLoop(FillBuffer *buf);
+  void DrainFillBuffers();
+  void WriteDump();
+  bool AnalyseEvent(eudaq::EventSP evsp, SimpleStandardEvent &simpEv);
+  void FillEvent(const SimpleStandardEvent &simpEv);
+
   std::vector<BaseCollection *> _colls;
   OnlineMonWindow *onlinemon;
   std::string rootfilename;
   std::string configfilename;
   bool _writeRoot;
-  bool _planesInitialized;
+  // used instead of the window settings when running headless
+  unsigned int _reduce;
+  bool _autoReset;
+  bool _offline;
   HitmapCollection *hmCollection;
   CorrelationCollection *corrCollection;
   EUDAQMonitorCollection *eudaqCollection;
   ParaMonitorCollection *paraCollection;
+  MonitorPerformanceCollection *monCollection;
   string snapshotdir;
   bool useTrackCorrelator;
-  TStopwatch my_event_processing_time;
-  TStopwatch my_event_inner_operations_time;
-  double previous_event_analysis_time;
-  double previous_event_fill_time;
-  double previous_event_clustering_time;
-  double previous_event_correlation_time;
+  std::atomic<double> previous_event_analysis_time;
+  std::atomic<double> previous_event_fill_time;
+  std::atomic<double> previous_event_clustering_time;
+  std::atomic<double> previous_event_correlation_time;
   unsigned int tracksPerEvent;
+  std::mutex m_mtx_plane_c;
   uint32_t m_plane_c;
   uint32_t m_ev_rec_n = 0;
+
+  unsigned int m_threads;
+  std::vector<std::thread> m_workers;
+  std::vector<std::unique_ptr<FillBuffer>> m_fill_buffers;
+  std::mutex m_mtx_fill;
+  std::mutex m_mtx_in;
+  std::condition_variable m_cv_in;
+  std::condition_variable m_cv_out;
+  std::deque<eudaq::EventSP> m_que_in;
+  size_t m_que_in_max;
+  size_t m_fill_buffer_max;
+  unsigned int m_busy;
+  bool m_exit;
+
+  unsigned int m_dump_interval;
+  std::string m_dump_dir;
+  std::chrono::steady_clock::time_point m_next_dump;
 };
 
 #ifdef __CINT__
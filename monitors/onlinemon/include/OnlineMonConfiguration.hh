@@ -36,6 +36,14 @@ class OnlineMonConfiguration {
 
   double getHotpixelcut() const;
   void setHotpixelcut(double hotpixelcut);
+  double getHotpixeldecay() const;
+  void setHotpixeldecay(double hotpixeldecay);
+  unsigned int getHotpixelupdate() const;
+  void setHotpixelupdate(unsigned int hotpixelupdate);
+  unsigned int getHotpixeltopk() const;
+  void setHotpixeltopk(unsigned int hotpixeltopk);
+  unsigned int getHotpixelmaxpixels() const;
+  void setHotpixelmaxpixels(unsigned int hotpixelmaxpixels);
 
   unsigned int getMimosa26_max_sections() const;
   void setMimosa26_max_sections(unsigned int mimosa26_max_sections);
@@ -64,6 +72,10 @@ class OnlineMonConfiguration {
 
   // hotcluster finder settings
   double hotpixelcut;
+  double hotpixeldecay;           // events, 0: average since the last reset
+  unsigned int hotpixelupdate;    // events between two hot pixel searches
+  unsigned int hotpixeltopk;      // length of the list of hottest pixels
+  unsigned int hotpixelmaxpixels; // pixels kept per plane
 
   // helper functions
   // Removes a specifici character from a string
@@ -28,6 +28,9 @@
 #include <TGraph.h>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <chrono>
+#include <utility>
 #include "BaseCollection.hh"
 #include "OnlineMon.hh"
 
@@ -75,6 +78,11 @@ class OnlineMonWindow : public TGMainFrame {
   std::map<std::string, std::string> _hitmapOptions;
   std::map<std::string, unsigned int> _logScaleMap;
   std::map<std::string, std::mutex*> _mutexMap;
+  // copies drawn on the canvas, and what they looked like when copied
+  std::map<std::string, TNamed *> _snapshotMap;
+  std::map<std::string, std::pair<double, int>> _drawnMap;
+  std::chrono::steady_clock::time_point _nextRedraw;
+  void clearSnapshots();
   TGListTreeItem *Itm_Eudet;
   TGListTreeItem *Itm_DUT;
   TGListTreeItem *Itm_EudetHM;
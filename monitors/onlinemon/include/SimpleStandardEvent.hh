@@ -50,7 +50,9 @@ class SimpleStandardEvent {
   SimpleStandardEvent();
 
   void addPlane(SimpleStandardPlane &plane);
-  SimpleStandardPlane getPlane(const int i) const { return _planes.at(i); }
+  const SimpleStandardPlane &getPlane(const int i) const {
+    return _planes.at(i);
+  }
   int getNPlanes() const { return _planes.size(); }
   void doClustering();
   double getMonitor_eventanalysistime() const;
@@ -61,6 +63,9 @@ class SimpleStandardEvent {
   void setMonitor_eventfilltime(double monitor_eventfilltime);
   void setMonitor_eventclusteringtime(double monitor_eventclusteringtime);
   void setMonitor_eventcorrelationtime(double monitor_eventcorrelationtime);
+  //! wall-clock stamp in ns of a eudaq::LatencyStamp::Hop, 0 if unknown
+  uint64_t getLatency_stamp(unsigned int hop) const;
+  void setLatency_stamp(unsigned int hop, uint64_t ns);
 
   unsigned int getEvent_number() const;
   void setEvent_number(unsigned int event_number);
@@ -75,6 +80,7 @@ class SimpleStandardEvent {
   double monitor_eventanalysistime;
   double monitor_clusteringtime; // stores the time to fill the histogram
   double monitor_correlationtime;
+  std::vector<uint64_t> latency_stamps; // empty if the event has none
   unsigned int event_number;
   uint64_t event_timestamp;
   std::map<std::string, double> slowpara;
@@ -8,6 +8,10 @@
 #include "CorrelationCollection.hh"
 #include "OnlineMon.hh"
 
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+
 CorrelationCollection::CorrelationCollection()
     : BaseCollection(), _map(), _planes(), skip_this_plane(),
       correlateAllPlanes(false), selected_planes_to_skip(),
@@ -15,7 +19,7 @@ CorrelationCollection::CorrelationCollection()
   CollectionType = CORRELATION_COLLECTION_TYPE;
 }
 
-bool checkIfClusterIsBigEnough(SimpleStandardCluster oneCluster) {
+bool checkIfClusterIsBigEnough(const SimpleStandardCluster &oneCluster) {
   if (oneCluster.getNPixel() == 1) {
     //(Phill) Should this say that NPixel is equal to one or greater than or
     //equal to one?
@@ -87,20 +91,12 @@ void CorrelationCollection::Reset() {
   }
 }
 
-void CorrelationCollection::Fill(const SimpleStandardEvent &simpev) {
-  // int totalFills = 0;
-  int nPlanes = simpev.getNPlanes();
-  int nPlanes_disabled = 0;
-
-  unsigned int plane_vector_size = 0;
-  if (skip_this_plane.size() == 0) // do this only at the very first event
+int CorrelationCollection::updateSkippedPlanes(const int nPlanes) {
+  if ((int)skip_this_plane.size() != nPlanes) // first event or new geometry
   {
+    int nPlanes_disabled = 0;
     selected_planes_to_skip = _mon->mon_configdata.getPlanes_to_be_skipped();
-    skip_this_plane.reserve(nPlanes);
-    // init vector
-    for (int elements = 0; elements < nPlanes; elements++) {
-      skip_this_plane[elements] = false;
-    }
+    skip_this_plane.assign(nPlanes, false);
     // now get vector of planes to be disabled and set the corresponding entries
     // to true
     for (unsigned int skipplanes = 0;
@@ -117,6 +113,52 @@ void CorrelationCollection::Fill(const SimpleStandardEvent &simpev) {
       std::cout << "CorrelationCollection : Disabling " << nPlanes_disabled
                 << " Planes" << endl;
   }
+  return std::count(skip_this_plane.begin(), skip_this_plane.end(), true);
+}
+
+void CorrelationCollection::registerPlane(const SimpleStandardPlane &simpPlane,
+                                          const int planeIndex) {
+  unsigned int plane_vector_size =
+      _planes.size(); // how many planes we did look at beforehand
+  if (correlateAllPlanes) {
+    for (unsigned int oldPlanes = 0; oldPlanes < plane_vector_size;
+         oldPlanes++) {
+      registerPlaneCorrelations(
+          _planes.at(oldPlanes),
+          simpPlane); // Correlating this plane with all the other ones
+    }
+  } else // we have deselected a few planes
+  {
+    if (!skip_this_plane[planeIndex]) {
+      for (unsigned int oldPlanes = 0; oldPlanes < plane_vector_size;
+           oldPlanes++) {
+        if (!skip_this_plane[oldPlanes]) {
+          registerPlaneCorrelations(_planes.at(oldPlanes),
+                                    simpPlane); // Correlating this plane
+                                                // with all the other ones
+        }
+      }
+    }
+  }
+  _planes.push_back(simpPlane); // we have to deal with all planes
+}
+
+CorrelationHistos *
+CorrelationCollection::findCorrelationHistos(const SimpleStandardPlane &p1,
+                                             const SimpleStandardPlane &p2) {
+  // the map compares name and id only, keep the hits out of the key
+  auto it = _map.find(std::make_pair(SimpleStandardPlane(p1.getName(), p1.getID()),
+                                     SimpleStandardPlane(p2.getName(), p2.getID())));
+  if (it == _map.end()) {
+    return NULL;
+  }
+  return it->second;
+}
+
+void CorrelationCollection::Fill(const SimpleStandardEvent &simpev) {
+  int nPlanes = simpev.getNPlanes();
+  int nPlanes_disabled = updateSkippedPlanes(nPlanes);
+
   if (nPlanes - nPlanes_disabled < 2) {
     if (nPlanes > 2)
       std::cout << "CorrelationCollection : Too Many Planes Disabled ..."
@@ -125,29 +167,7 @@ void CorrelationCollection::Fill(const SimpleStandardEvent &simpev) {
     for (int planeA = 0; planeA < nPlanes; planeA++) {
       const SimpleStandardPlane &simpPlane = simpev.getPlane(planeA);
       if (!isPlaneRegistered(simpPlane)) {
-        plane_vector_size =
-            _planes.size(); // how many planes we did look at beforehand
-        if (correlateAllPlanes) {
-          for (unsigned int oldPlanes = 0; oldPlanes < plane_vector_size;
-               oldPlanes++) {
-            registerPlaneCorrelations(
-                _planes.at(oldPlanes),
-                simpPlane); // Correlating this plane with all the other ones
-          }
-        } else // we have deselected a few planes
-        {
-          if (!skip_this_plane[planeA]) {
-            for (unsigned int oldPlanes = 0; oldPlanes < plane_vector_size;
-                 oldPlanes++) {
-              if (!skip_this_plane[oldPlanes]) {
-                registerPlaneCorrelations(_planes.at(oldPlanes),
-                                          simpPlane); // Correlating this plane
-                                                      // with all the other ones
-              }
-            }
-          }
-        }
-        _planes.push_back(simpPlane); // we have to deal with all planes
+        registerPlane(simpPlane, planeA);
       }
       for (int planeB = planeA + 1; planeB < nPlanes; planeB++) {
         if ((skip_this_plane[planeA] == false) &&
@@ -161,161 +181,131 @@ void CorrelationCollection::Fill(const SimpleStandardEvent &simpev) {
   }
 }
 
+void ClusterGrid::Build(const std::vector<SimpleStandardCluster> &clusters,
+                        const int width) {
+  _width = width;
+  _x.clear();
+  _y.clear();
+  _cells.clear();
+  _used.assign(clusters.size(), false);
+  if (_width <= 0) {
+    return;
+  }
+  _x.reserve(clusters.size());
+  _y.reserve(clusters.size());
+  for (unsigned int i = 0; i < clusters.size(); ++i) {
+    _x.push_back(clusters[i].getX());
+    _y.push_back(clusters[i].getY());
+    _cells[cell(_x.back(), _y.back())].push_back(i);
+  }
+}
+
+int ClusterGrid::Find(const int x, const int y) const {
+  int best = -1;
+  if (_width <= 0) {
+    return best;
+  }
+  // anything closer than the width sits in one of the 3x3 cells around x, y
+  const int cx = floorDiv(x, _width);
+  const int cy = floorDiv(y, _width);
+  for (int dx = -1; dx <= 1; ++dx) {
+    for (int dy = -1; dy <= 1; ++dy) {
+      auto it = _cells.find(key(cx + dx, cy + dy));
+      if (it == _cells.end()) {
+        continue;
+      }
+      for (unsigned int i : it->second) {
+        if ((int)i > best && !_used[i] && abs(_x[i] - x) < _width &&
+            abs(_y[i] - y) < _width) {
+          best = i;
+        }
+      }
+    }
+  }
+  return best;
+}
+
 unsigned int
 CorrelationCollection::FillWithTracks(const SimpleStandardEvent &simpev) {
   int nPlanes = simpev.getNPlanes();
-  int nPlanes_disabled = 0;
-  std::vector<vector<SimpleStandardCluster>> clustersInPlanes;
+  int nPlanes_disabled = updateSkippedPlanes(nPlanes);
   std::vector<vector<pair<int, SimpleStandardCluster>>> reconstructedTracks;
-  std::vector<pair<int, SimpleStandardCluster>> singleTrack;
-  singleTrack.reserve(nPlanes);
-  bool noClusterFound;
-  const int lastPlane = nPlanes - 1;
-  SimpleStandardCluster tempCluster;
-  bool correlationDecission;
-
-  unsigned int plane_vector_size = 0;
-  if (skip_this_plane.size() == 0) // do this only at the very first event
-  {
-    selected_planes_to_skip = _mon->mon_configdata.getPlanes_to_be_skipped();
-    skip_this_plane.reserve(nPlanes);
-    // init vector
-    for (int elements = 0; elements < nPlanes; elements++) {
-      skip_this_plane[elements] = false;
-    }
-    // now get vector of planes to be disabled and set the corresponding entries
-    // to true
-    for (unsigned int skipplanes = 0;
-         skipplanes < selected_planes_to_skip.size(); skipplanes++) {
-      if ((selected_planes_to_skip[skipplanes] > 0) &&
-          (selected_planes_to_skip[skipplanes] < nPlanes)) {
-        skip_this_plane[selected_planes_to_skip[skipplanes]] = true;
-        std::cout << "CorrelationCollection : Disabling Plane "
-                  << selected_planes_to_skip[skipplanes] << endl;
-        nPlanes_disabled++;
-      }
-    }
-    if (nPlanes_disabled > 0)
-      std::cout << "CorrelationCollection : Disabling " << nPlanes_disabled
-                << " Planes" << endl;
-  }
+
   if (nPlanes - nPlanes_disabled < 2) {
     if (nPlanes > 2)
       std::cout << "CorrelationCollection : Too Many Planes Disabled ..."
                 << endl;
-  } else {
-    clustersInPlanes.reserve(nPlanes);
+    return 0;
+  }
 
-    for (int planeA = 0; planeA < nPlanes; planeA++) {
-      const SimpleStandardPlane &simpPlane = simpev.getPlane(planeA);
-      if (skip_this_plane[planeA] ==
-          false) // adding plane for analysis if selected
-      {
-        vector<SimpleStandardCluster> clustersBeforeDeletion =
-            simpPlane.getClusters();
-        vector<SimpleStandardCluster> clustersAfterDeletion;
-        clustersAfterDeletion.reserve(20);
-        remove_copy_if(
-            clustersBeforeDeletion.begin(), clustersBeforeDeletion.end(),
-            back_inserter(clustersAfterDeletion), checkIfClusterIsBigEnough);
-        //                cout<< "Clusters: " << clustersAfterDeletion.size() <<
-        //                endl;
-        clustersInPlanes.push_back(clustersAfterDeletion);
-
-        if (!isPlaneRegistered(simpPlane)) {
-          plane_vector_size =
-              _planes.size(); // how many planes we did look at beforehand
-
-          if (correlateAllPlanes)
-            for (unsigned int oldPlanes = 0; oldPlanes < plane_vector_size;
-                 oldPlanes++)
-              registerPlaneCorrelations(
-                  _planes.at(oldPlanes),
-                  simpPlane); // Correlating this plane with all the other ones
-
-          else // we have deselected a few planes
-              if (!skip_this_plane[planeA])
-            for (unsigned int oldPlanes = 0; oldPlanes < plane_vector_size;
-                 oldPlanes++)
-              if (!skip_this_plane[oldPlanes])
-                registerPlaneCorrelations(_planes.at(oldPlanes),
-                                          simpPlane); // Correlating this plane
-                                                      // with all the other ones
-          _planes.push_back(simpPlane); // we have to deal with all planes
-        }
+  // clusters of all selected planes, sorted by position, and the event plane
+  // they came from
+  if (_trackClusters.size() < (unsigned int)nPlanes) {
+    _trackClusters.resize(nPlanes);
+    _trackGrids.resize(nPlanes);
+  }
+  std::vector<int> planeIndex;
+  planeIndex.reserve(nPlanes);
+  for (int planeA = 0; planeA < nPlanes; planeA++) {
+    const SimpleStandardPlane &simpPlane = simpev.getPlane(planeA);
+    if (skip_this_plane[planeA] ==
+        false) // adding plane for analysis if selected
+    {
+      std::vector<SimpleStandardCluster> &clusters =
+          _trackClusters[planeIndex.size()];
+      clusters.clear();
+      remove_copy_if(simpPlane.getClusters().begin(),
+                     simpPlane.getClusters().end(), back_inserter(clusters),
+                     checkIfClusterIsBigEnough);
+      std::sort(clusters.begin(), clusters.end(), SortClustersByXY());
+      _trackGrids[planeIndex.size()].Build(clusters,
+                                           getWindowWidthForCorrelation());
+      planeIndex.push_back(planeA);
+
+      if (!isPlaneRegistered(simpPlane)) {
+        registerPlane(simpPlane, planeA);
       }
     }
   }
-  for (unsigned int plane = 0; plane < clustersInPlanes.size(); ++plane)
-    std::sort(clustersInPlanes.at(plane).begin(),
-              clustersInPlanes.at(plane).end(), SortClustersByXY());
-
-  for (unsigned int currPlaneIndex = 0;
-       currPlaneIndex < clustersInPlanes.size() - 2; ++currPlaneIndex) {
-    std::vector<SimpleStandardCluster> &currentPlane =
-        clustersInPlanes.at(currPlaneIndex);
-
-    singleTrack.clear();
-    while (currentPlane.size() > 0) {
-      if (singleTrack.size() > 0)
-        singleTrack.clear();
-
-      while (singleTrack.size() == 0 && currentPlane.size() > 0) {
-        tempCluster = currentPlane.back();
-        if (tempCluster.getNPixel() >=
-            _mon->mon_configdata.getCorrel_minclustersize()) {
-          std::pair<int, SimpleStandardCluster> trackPair(currPlaneIndex,
-                                                          tempCluster);
-          singleTrack.push_back(trackPair);
-        }
-        currentPlane.pop_back();
-      }
 
-      if (singleTrack.size() > 0) {
-        for (int nextPlaneIndex = ++currPlaneIndex; nextPlaneIndex < nPlanes;
-             ++nextPlaneIndex) {
-          std::vector<SimpleStandardCluster> &clustersInNextPlane =
-              clustersInPlanes.at(nextPlaneIndex);
-          noClusterFound = false;
-
-          //                    for(std::vector<SimpleStandardCluster>::iterator
-          //                    it = --nextPlane.end(); it >= nextPlane.begin();
-          //                    --it)
-          //                    int currentSize = clustersInNextPlane.size();
-          for (int currentclusterIndex = clustersInNextPlane.size() - 1;
-               currentclusterIndex >= 0; --currentclusterIndex) {
-            SimpleStandardCluster &currentCluster =
-                clustersInNextPlane.at(currentclusterIndex);
-            //                        if( currentCluster.getNPixel() >=
-            //                        _mon->mon_configdata.getCorrel_minclustersize()
-            //                                &&
-            //                                checkCorrelations(singleTrack.back().second,
-            //                                currentCluster) )
-
-            if (simpev.getPlane(currPlaneIndex).is_MIMOSA26 &&
-                simpev.getPlane(nextPlaneIndex).is_MIMOSA26)
-              correlationDecission =
-                  checkCorrelations(singleTrack.back().second, currentCluster);
-            else
-              correlationDecission = checkCorrelations(
-                  singleTrack.back().second, currentCluster, false);
-            if (correlationDecission) {
-              std::pair<int, SimpleStandardCluster> trackPair(nextPlaneIndex,
-                                                              currentCluster);
-              singleTrack.push_back(trackPair);
-              clustersInNextPlane.erase(clustersInNextPlane.begin() +
-                                        currentclusterIndex);
-              break;
-            } else if (currentclusterIndex == 0)
-              noClusterFound = true;
-          }
-
-          if (nextPlaneIndex == lastPlane || noClusterFound) {
-            if (singleTrack.size() >= getPlanesNumberForCorrelation())
-              reconstructedTracks.push_back(singleTrack);
-          }
+  const int minclustersize = _mon->mon_configdata.getCorrel_minclustersize();
+  std::vector<pair<int, SimpleStandardCluster>> singleTrack;
+  singleTrack.reserve(planeIndex.size());
+  // every unused cluster seeds a track, which picks up the closest unused
+  // cluster inside the window in each following plane
+  for (unsigned int seedPlane = 0; seedPlane + 2 < planeIndex.size();
+       ++seedPlane) {
+    const std::vector<SimpleStandardCluster> &seeds = _trackClusters[seedPlane];
+    for (int seed = seeds.size() - 1; seed >= 0; --seed) {
+      if (_trackGrids[seedPlane].isUsed(seed) ||
+          seeds[seed].getNPixel() < minclustersize) {
+        continue;
+      }
+      _trackGrids[seedPlane].setUsed(seed);
+      singleTrack.clear();
+      singleTrack.push_back(make_pair(planeIndex[seedPlane], seeds[seed]));
+      int lastX = seeds[seed].getX();
+      int lastY = seeds[seed].getY();
+
+      for (unsigned int nextPlane = seedPlane + 1;
+           nextPlane < planeIndex.size(); ++nextPlane) {
+        // only Mimosa26 planes are correlated, see checkCorrelations
+        if (!simpev.getPlane(singleTrack.back().first).is_MIMOSA26 ||
+            !simpev.getPlane(planeIndex[nextPlane]).is_MIMOSA26) {
+          continue;
+        }
+        int match = _trackGrids[nextPlane].Find(lastX, lastY);
+        if (match < 0) {
+          continue;
         }
+        _trackGrids[nextPlane].setUsed(match);
+        const SimpleStandardCluster &cluster = _trackClusters[nextPlane][match];
+        singleTrack.push_back(make_pair(planeIndex[nextPlane], cluster));
+        lastX = cluster.getX();
+        lastY = cluster.getY();
       }
+      if (singleTrack.size() >= getPlanesNumberForCorrelation())
+        reconstructedTracks.push_back(singleTrack);
     }
   }
   fillHistograms(reconstructedTracks, simpev);
@@ -323,12 +313,13 @@ CorrelationCollection::FillWithTracks(const SimpleStandardEvent &simpev) {
 }
 
 void CorrelationCollection::fillHistograms(
-    std::vector<vector<pair<int, SimpleStandardCluster>>> tracks,
+    const std::vector<vector<pair<int, SimpleStandardCluster>>> &tracks,
     const SimpleStandardEvent &simpEv) {
 
   for (unsigned int trackNr = 0; trackNr < tracks.size(); ++trackNr) {
-    vector<pair<int, SimpleStandardCluster>> &currentTrack = tracks.at(trackNr);
-    for (unsigned int clusterPair1 = 0; clusterPair1 < currentTrack.size() - 1;
+    const vector<pair<int, SimpleStandardCluster>> &currentTrack =
+        tracks.at(trackNr);
+    for (unsigned int clusterPair1 = 0; clusterPair1 + 1 < currentTrack.size();
          ++clusterPair1) {
       for (unsigned int clusterPair2 = clusterPair1 + 1;
            clusterPair2 < currentTrack.size(); ++clusterPair2) {
@@ -340,12 +331,12 @@ void CorrelationCollection::fillHistograms(
             simpEv.getPlane(currentTrack.at(clusterPair2).first);
         const SimpleStandardCluster &secondCluster =
             currentTrack.at(clusterPair2).second;
-        pair<SimpleStandardPlane, SimpleStandardPlane> planePair(firstPlane,
-                                                                 secondPlane);
-        CorrelationHistos *corrmap = _map[planePair];
-
-        corrmap->Fill(firstCluster, secondCluster);
-	corrmap->FillCorrVsTime(firstCluster, secondCluster, simpEv);
+        CorrelationHistos *corrmap =
+            findCorrelationHistos(firstPlane, secondPlane);
+        if (corrmap) {
+          corrmap->Fill(firstCluster, secondCluster);
+          corrmap->FillCorrVsTime(firstCluster, secondCluster, simpEv);
+        }
       }
     }
   }
@@ -355,32 +346,28 @@ void CorrelationCollection::fillHistograms(const SimpleStandardPlane &p1,
                                            const SimpleStandardPlane &p2,
 					   const SimpleStandardEvent &simpEv) {
 
-  std::pair<SimpleStandardPlane, SimpleStandardPlane> plane(p1, p2);
-  CorrelationHistos *corrmap = _map[plane];
+  CorrelationHistos *corrmap = findCorrelationHistos(p1, p2);
   if (corrmap) {
-    const std::vector<SimpleStandardCluster> aClusters = p1.getClusters();
-    const std::vector<SimpleStandardCluster> bClusters = p2.getClusters();
-
-    for (unsigned int acluster = 0; acluster < aClusters.size(); acluster++) {
-      const SimpleStandardCluster &oneAcluster = aClusters.at(acluster);
-      if (oneAcluster.getNPixel() <
-          _mon->mon_configdata.getCorrel_minclustersize()) // we are only
-                                                           // interested in
-                                                           // clusters with
-                                                           // several pixels
-      {
-        continue;
+    // we are only interested in clusters with several pixels, every pair of
+    // those is filled, so select them once instead of per pair
+    const int minclustersize = _mon->mon_configdata.getCorrel_minclustersize();
+    _aClusters.clear();
+    _bClusters.clear();
+    for (const SimpleStandardCluster &c : p1.getClusters()) {
+      if (c.getNPixel() >= minclustersize) {
+        _aClusters.push_back(&c);
       }
-      for (unsigned int bcluster = 0; bcluster < bClusters.size(); bcluster++) {
-        const SimpleStandardCluster &oneBcluster = bClusters.at(bcluster);
-        //
-        if (oneBcluster.getNPixel() <
-            _mon->mon_configdata.getCorrel_minclustersize()) {
-          continue;
-        } else {
-          corrmap->Fill(oneAcluster, oneBcluster);
-	  corrmap->FillCorrVsTime(oneAcluster, oneBcluster, simpEv);
-        }
+    }
+    for (const SimpleStandardCluster &c : p2.getClusters()) {
+      if (c.getNPixel() >= minclustersize) {
+        _bClusters.push_back(&c);
+      }
+    }
+
+    for (const SimpleStandardCluster *oneAcluster : _aClusters) {
+      for (const SimpleStandardCluster *oneBcluster : _bClusters) {
+        corrmap->Fill(*oneAcluster, *oneBcluster);
+        corrmap->FillCorrVsTime(*oneAcluster, *oneBcluster, simpEv);
       }
     }
   }
@@ -395,7 +382,7 @@ void CorrelationCollection::registerPlaneCorrelations(
   pair<SimpleStandardPlane, SimpleStandardPlane> pdouble(p1, p2);
   _map[pdouble] = tmphisto;
 
-  if (_mon != NULL) {
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
     std::string dirName;
 
     if (_mon->getUseTrack_corr() == true)
@@ -427,7 +414,7 @@ void CorrelationCollection::registerPlaneCorrelations(
   }
 
 
-  if (_mon != NULL) {
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
     std::string dirName;
 
     if (_mon->getUseTrack_corr() == true)
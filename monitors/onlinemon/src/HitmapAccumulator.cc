@@ -0,0 +1,115 @@
+#include "HitmapAccumulator.hh"
+
+DenseCounter::DenseCounter(int min, int max)
+    : _min(min), _counts(max > min ? max - min : 0) {}
+
+void DenseCounter::Fill(int value) {
+  unsigned int i = static_cast<unsigned int>(value - _min);
+  if (i < _counts.size()) {
+    _counts[i].fetch_add(1, std::memory_order_relaxed);
+  } else {
+    std::lock_guard<std::mutex> lck(_mu);
+    _outside[value]++;
+  }
+}
+
+void DenseCounter::Take(std::vector<std::pair<int, uint32_t>> &counts) {
+  for (unsigned int i = 0; i < _counts.size(); ++i) {
+    if (_counts[i].load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    uint32_t c = _counts[i].exchange(0, std::memory_order_relaxed);
+    if (c != 0) {
+      counts.emplace_back(_min + static_cast<int>(i), c);
+    }
+  }
+  std::lock_guard<std::mutex> lck(_mu);
+  counts.insert(counts.end(), _outside.begin(), _outside.end());
+  _outside.clear();
+}
+
+void DenseCounter::Reset() {
+  for (auto &c : _counts) {
+    c.store(0, std::memory_order_relaxed);
+  }
+  std::lock_guard<std::mutex> lck(_mu);
+  _outside.clear();
+}
+
+HitmapAccumulator::HitmapAccumulator(int maxX, int maxY,
+                                     unsigned int nsections,
+                                     int section_boundary)
+    : _maxX(maxX > 0 ? maxX : 0), _maxY(maxY > 0 ? maxY : 0),
+      _section_boundary(section_boundary > 0 ? section_boundary : 1),
+      _hitmap(_maxX * _maxY), _hot((_maxX * _maxY + 63) / 64),
+      _x(0, _maxX), _y(0, _maxY), _sections(0, nsections), _tot(-128, 1024),
+      _lvl1(0, 256) {}
+
+void HitmapAccumulator::FillHit(int x, int y, bool sections) {
+  if (x >= 0 && x < _maxX && y >= 0 && y < _maxY) {
+    if (IsHot(x, y)) {
+      return;
+    }
+    _hitmap[x * _maxY + y].fetch_add(1, std::memory_order_relaxed);
+  } else {
+    std::lock_guard<std::mutex> lck(_mu);
+    _outside[std::make_pair(x, y)]++;
+  }
+  _x.Fill(x);
+  _y.Fill(y);
+  if (sections) {
+    _sections.Fill(x / _section_boundary);
+  }
+}
+
+bool HitmapAccumulator::IsHot(int x, int y) const {
+  if (x < 0 || x >= _maxX || y < 0 || y >= _maxY) {
+    return false;
+  }
+  unsigned int i = x * _maxY + y;
+  return (_hot[i / 64].load(std::memory_order_relaxed) >> (i % 64)) & 1;
+}
+
+void HitmapAccumulator::SetHot(int x, int y) {
+  if (x < 0 || x >= _maxX || y < 0 || y >= _maxY) {
+    return;
+  }
+  unsigned int i = x * _maxY + y;
+  _hot[i / 64].fetch_or(uint64_t(1) << (i % 64), std::memory_order_relaxed);
+}
+
+void HitmapAccumulator::ClearHot() {
+  for (auto &h : _hot) {
+    h.store(0, std::memory_order_relaxed);
+  }
+}
+
+void HitmapAccumulator::TakeHitmap(
+    std::vector<std::pair<std::pair<int, int>, uint32_t>> &counts) {
+  for (unsigned int i = 0; i < _hitmap.size(); ++i) {
+    if (_hitmap[i].load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    uint32_t c = _hitmap[i].exchange(0, std::memory_order_relaxed);
+    if (c != 0) {
+      counts.emplace_back(std::make_pair(i / _maxY, i % _maxY), c);
+    }
+  }
+  std::lock_guard<std::mutex> lck(_mu);
+  counts.insert(counts.end(), _outside.begin(), _outside.end());
+  _outside.clear();
+}
+
+void HitmapAccumulator::Reset() {
+  for (auto &c : _hitmap) {
+    c.store(0, std::memory_order_relaxed);
+  }
+  ClearHot();
+  _x.Reset();
+  _y.Reset();
+  _sections.Reset();
+  _tot.Reset();
+  _lvl1.Reset();
+  std::lock_guard<std::mutex> lck(_mu);
+  _outside.clear();
+}
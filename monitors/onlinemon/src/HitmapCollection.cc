@@ -80,12 +80,11 @@ void HitmapCollection::Write(TFile *file) {
   }
 }
 
-void HitmapCollection::Calculate(const unsigned int currentEventNumber) {
-  if ((currentEventNumber > 10 && currentEventNumber % 1000 * _reduce == 0)) {
-    std::map<SimpleStandardPlane, HitmapHistos *>::iterator it;
-    for (it = _map.begin(); it != _map.end(); ++it) {
-      it->second->Calculate(currentEventNumber / _reduce);
-    }
+void HitmapCollection::Calculate(const unsigned int /*currentEventNumber*/) {
+  // each plane counts its own events and decides when to look for hot pixels
+  std::map<SimpleStandardPlane, HitmapHistos *>::iterator it;
+  for (it = _map.begin(); it != _map.end(); ++it) {
+    it->second->Calculate();
   }
 }
 
@@ -96,6 +95,13 @@ void HitmapCollection::Reset() {
   }
 }
 
+void HitmapCollection::Flush() {
+  std::map<SimpleStandardPlane, HitmapHistos *>::iterator it;
+  for (it = _map.begin(); it != _map.end(); ++it) {
+    it->second->Flush();
+  }
+}
+
 void HitmapCollection::Fill(const SimpleStandardEvent &simpev) {
 
   for (int plane = 0; plane < simpev.getNPlanes(); plane++) {
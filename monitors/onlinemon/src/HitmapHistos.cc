@@ -8,6 +8,7 @@
 #include "HitmapHistos.hh"
 #include "OnlineMon.hh"
 #include <cstdlib>
+#include <algorithm>
 
 HitmapHistos::HitmapHistos(SimpleStandardPlane p, RootMonitor *mon)
     : _sensor(p.getName()), _id(p.getID()), _maxX(p.getMaxX()),
@@ -16,7 +17,8 @@ HitmapHistos::HitmapHistos(SimpleStandardPlane p, RootMonitor *mon)
       _lvl1Cluster(NULL), _totSingle(NULL), _totCluster(NULL), _hitOcc(NULL),
       _nClusters(NULL), _nHits(NULL), _clusterXWidth(NULL),
       _clusterYWidth(NULL), _nbadHits(NULL), _nHotPixels(NULL),
-      _hitmapSections(NULL), is_MIMOSA26(false), is_APIX(false),
+      _hitmapSections(NULL), _occ(NULL), _lastCalculate(0), _acc(NULL),
+      is_MIMOSA26(false), is_APIX(false),
       is_USBPIX(false), is_USBPIXI4(false) {
   char out[1024], out2[1024];
 
@@ -198,74 +200,98 @@ HitmapHistos::HitmapHistos(SimpleStandardPlane p, RootMonitor *mon)
         _nHotPixels_section[section]->GetXaxis()->SetTitle("Hot Pixels");
       }
     }
-    // make a plane array for calculating e..g hotpixels and occupancy
-
-    plane_map_array = new int *[_maxX];
-    if (plane_map_array != NULL) {
-      for (int j = 0; j < _maxX; j++) {
-        plane_map_array[j] = new int[_maxY];
-        if (plane_map_array[j] == NULL) {
-	  std::cerr << "HitmapHistos :Error in memory allocation" << endl;
-          exit(-1);
-        }
-      }
-      zero_plane_array();
-    }
+    // occupancy of the hit pixels for the hot pixel search
+    _occ = new OccupancyEstimator(_maxX, _maxY);
+    _occ->setDecay(_mon->mon_configdata.getHotpixeldecay());
+    _occ->setCapacity(_mon->mon_configdata.getHotpixelmaxpixels());
+
+    _acc = new HitmapAccumulator(
+        _maxX, _maxY, mimosa26_max_section,
+        _mon->mon_configdata.getMimosa26_section_boundary());
 
   } else {
     std::cerr << "No max sensorsize known!" << std::endl;
   }
 }
 
-int HitmapHistos::zero_plane_array() {
-  for (int i = 0; i < _maxX; i++) {
-    for (int j = 0; j < _maxY; j++) {
-      plane_map_array[i][j] = 0;
-    }
-  }
-  return 0;
+HitmapHistos::~HitmapHistos() {
+  delete _occ;
+  delete _acc;
 }
 
 void HitmapHistos::Fill(const SimpleStandardHit &hit) {
+  // nothing was booked for a sensor of unknown size
+  if (_acc == NULL)
+    return;
   int pixel_x = hit.getX();
   int pixel_y = hit.getY();
 
-  bool pixelIsHot = false;
-  if (_HotPixelMap->GetBinContent(pixel_x + 1, pixel_y + 1) >
-      _mon->mon_configdata.getHotpixelcut())
-    pixelIsHot = true;
+  // hitmap, projections and sections skip hot pixels
+  _acc->FillHit(pixel_x, pixel_y, is_MIMOSA26);
 
-  if (_hitmap != NULL && !pixelIsHot){
-    _hitmap->Fill(pixel_x, pixel_y);
+  if (_occ != NULL) {
+    _occ->Fill(pixel_x, pixel_y);
   }
-  if (_hitXmap != NULL && !pixelIsHot)
-    _hitXmap->Fill(pixel_x);
-  if (_hitYmap != NULL && !pixelIsHot)
-    _hitYmap->Fill(pixel_y);
-  if ((is_MIMOSA26) && (_hitmapSections != NULL) && (!pixelIsHot))
-  //&& _hitOcc->GetEntries()>0) // only fill histogram when occupancies and
-  //hotpixels have been determined
-  {
-    char sectionid[3];
-    sprintf(sectionid, "%i%c", _id,
-            (pixel_x / _mon->mon_configdata.getMimosa26_section_boundary()) +
-                65); // determine section label
-    _hitmapSections->Fill(sectionid,
-                          1); // add one hit to the corresponding section bin
+  if ((is_APIX) || (is_USBPIX) || (is_USBPIXI4) || (is_DEPFET)) {
+    _acc->FillTOT(hit.getTOT());
+    _acc->FillLVL1(hit.getLVL1());
   }
+}
 
-  if ((pixel_x < _maxX) && (pixel_y < _maxY)) {
-    plane_map_array[pixel_x][pixel_y] = plane_map_array[pixel_x][pixel_y] + 1;
+void HitmapHistos::FlushCounts(TH1 *histo) {
+  if (histo != NULL) {
+    for (auto &c : _flush_counts) {
+      histo->AddBinContent(histo->FindBin(c.first), c.second);
+    }
+    histo->ResetStats();
   }
-  if ((is_APIX) || (is_USBPIX) || (is_USBPIXI4) || (is_DEPFET)) {
-    if (_totSingle != NULL)
-      _totSingle->Fill(hit.getTOT());
-    if (_lvl1Distr != NULL)
-      _lvl1Distr->Fill(hit.getLVL1());
+  _flush_counts.clear();
+}
+
+void HitmapHistos::Flush() {
+  if (_acc == NULL) {
+    return;
+  }
+  _acc->TakeHitmap(_flush_hitmap);
+  if (_hitmap != NULL) {
+    for (auto &c : _flush_hitmap) {
+      _hitmap->AddBinContent(
+          _hitmap->FindBin(c.first.first, c.first.second), c.second);
+    }
+    _hitmap->ResetStats();
+  }
+  _flush_hitmap.clear();
+
+  _acc->TakeX(_flush_counts);
+  FlushCounts(_hitXmap);
+  _acc->TakeY(_flush_counts);
+  FlushCounts(_hitYmap);
+  _acc->TakeTOT(_flush_counts);
+  FlushCounts(_totSingle);
+  _acc->TakeLVL1(_flush_counts);
+  FlushCounts(_lvl1Distr);
+
+  _acc->TakeSections(_flush_counts);
+  if (_hitmapSections != NULL) {
+    for (auto &c : _flush_counts) {
+      if (c.first >= 0 && c.first < (int)mimosa26_max_section) {
+        _hitmapSections->AddBinContent(c.first + 1, c.second);
+      } else { // beyond the booked sections, let ROOT add a labelled bin
+        char sectionid[32];
+        sprintf(sectionid, "%i%c", _id, c.first + 65);
+        for (uint32_t n = 0; n < c.second; n++) {
+          _hitmapSections->Fill(sectionid, 1);
+        }
+      }
+    }
+    _hitmapSections->ResetStats();
   }
+  _flush_counts.clear();
 }
 
 void HitmapHistos::Fill(const SimpleStandardPlane &plane) {
+  if (_occ != NULL)
+    _occ->AddEvent();
   if (_nHits != NULL)
     _nHits->Fill(plane.getNHits());
   if ((_nbadHits != NULL) && (plane.getNBadHits() > 0)) {
@@ -353,54 +379,70 @@ void HitmapHistos::Reset() {
     _nClustersize_section[section]->Reset();
     _nHotPixels_section[section]->Reset();
   }
-  // we have to reset the aux array as well
-  zero_plane_array();
+  // we have to reset the occupancies as well
+  if (_occ != NULL) {
+    _occ->Reset();
+  }
+  _lastCalculate = 0;
+  _hotPixels.clear();
+  _topHotPixels.clear();
+  if (_acc != NULL) {
+    _acc->Reset();
+  }
 }
 
-void HitmapHistos::Calculate(const int currentEventNum) {
+void HitmapHistos::Calculate() {
+  if (_occ == NULL) {
+    return;
+  }
+  uint64_t nevents = _occ->getEvents();
+  if (nevents <= 10 ||
+      nevents - _lastCalculate < _mon->mon_configdata.getHotpixelupdate()) {
+    return;
+  }
+  _lastCalculate = nevents;
   _wait = true;
-  _hitOcc->SetBins(currentEventNum / 10, 0, 1);
+  _hitOcc->SetBins(nevents / 10, 0, 1);
   _hitOcc->Reset();
 
-  int nHotpixels = 0;
-  std::vector<unsigned int> nHotpixels_section;
   double Hotpixelcut = _mon->mon_configdata.getHotpixelcut();
-  double bin = 0;
-  double occupancy = 0;
-  if (is_MIMOSA26) // probalbly initialize vector
-  {
-    nHotpixels_section.reserve(_mon->mon_configdata.getMimosa26_max_sections());
-    for (unsigned int i = 0; i < _mon->mon_configdata.getMimosa26_max_sections(); i++) {
-      nHotpixels_section[i] = 0;
-    }
+  _occ->Update(Hotpixelcut, _mon->mon_configdata.getHotpixeltopk(), _hotPixels,
+               &_occupancies);
+  for (unsigned int i = 0; i < _occupancies.size(); i++) {
+    // FIXME it's not occupancy, it's frequency
+    _hitOcc->Fill(_occupancies[i]);
+  }
+  // only count as hotpixel if occupancy larger than minimal occupancy for
+  // a single hit
+  if ((1. / (double)nevents) >= Hotpixelcut) {
+    _hotPixels.clear();
   }
 
-  for (int x = 0; x < _maxX; ++x) {
-    for (int y = 0; y < _maxY; ++y) {
-
-      bin = plane_map_array[x][y];
-
-      if (bin != 0) {
-        occupancy = bin / (double)currentEventNum; // FIXME it's not occupancy, it's frequency
-        _hitOcc->Fill(occupancy);
-        // only count as hotpixel if occupancy larger than minimal occupancy for
-        // a single hit
-        if (occupancy > Hotpixelcut && ((1. / (double)(currentEventNum)) <
-                                        _mon->mon_configdata.getHotpixelcut())){
-          nHotpixels++;
-          _HotPixelMap->SetBinContent(x + 1, y + 1, occupancy); // ROOT start from 1
-          if (is_MIMOSA26) {
-            nHotpixels_section[x / _mon->mon_configdata.getMimosa26_section_boundary()]++;
-          }
-        }
-      }
+  // the mask follows the current occupancies, pixels can cool down again
+  _HotPixelMap->Reset();
+  _acc->ClearHot();
+  std::vector<unsigned int> nHotpixels_section;
+  if (is_MIMOSA26) {
+    nHotpixels_section.resize(mimosa26_max_section, 0);
+  }
+  unsigned int boundary = _mon->mon_configdata.getMimosa26_section_boundary();
+  for (unsigned int i = 0; i < _hotPixels.size(); i++) {
+    const OccupancyEstimator::Pixel &p = _hotPixels[i];
+    _HotPixelMap->SetBinContent(p.x + 1, p.y + 1, p.occupancy); // ROOT start from 1
+    _acc->SetHot(p.x, p.y);
+    if (is_MIMOSA26 && p.x / boundary < mimosa26_max_section) {
+      nHotpixels_section[p.x / boundary]++;
     }
   }
+  unsigned int ntop = std::min<size_t>(_hotPixels.size(),
+                                       _mon->mon_configdata.getHotpixeltopk());
+  _topHotPixels.assign(_hotPixels.begin(), _hotPixels.begin() + ntop);
+
+  int nHotpixels = _hotPixels.size();
   if (nHotpixels > 0) {
     _nHotPixels->Fill(nHotpixels);
     if (is_MIMOSA26) {
-      for (unsigned int section = 0;
-           section < _mon->mon_configdata.getMimosa26_max_sections();
+      for (unsigned int section = 0; section < mimosa26_max_section;
            section++) {
         if ((nHotpixels_section[section] > 0)) {
           _nHotPixels_section[section]->Fill(nHotpixels_section[section]);
@@ -413,6 +455,7 @@ void HitmapHistos::Calculate(const int currentEventNum) {
 }
 
 void HitmapHistos::Write() {
+  Flush();
   _hitmap->Write();
   _hitXmap->Write();
   _hitYmap->Write();
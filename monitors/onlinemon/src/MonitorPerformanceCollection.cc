@@ -49,7 +49,7 @@ void MonitorPerformanceCollection::Fill(const SimpleStandardEvent &simpev) {
 
 void MonitorPerformanceCollection::bookHistograms(
     const SimpleStandardEvent & /*simpev*/) {
-  if (_mon != NULL) {
+  if (_mon != NULL && _mon->getOnlineMon() != NULL) {
     string performance_folder_name = "Monitor Performance";
     _mon->getOnlineMon()->registerTreeItem(
         (performance_folder_name + "/Data Analysis Time"));
@@ -84,6 +84,21 @@ void MonitorPerformanceCollection::bookHistograms(
         (performance_folder_name + "/Correlation Time"),
         mymonhistos->getMutex());
 
+    string latency_folder_name = performance_folder_name + "/Latency";
+    vector<pair<string, TH1 *>> latency_histos = {
+        {"Producer to Collector", mymonhistos->getProducerToCollectorHisto()},
+        {"Collector", mymonhistos->getCollectorHisto()},
+        {"Collector to Monitor", mymonhistos->getCollectorToMonitorHisto()},
+        {"Monitor", mymonhistos->getMonitorHisto()},
+        {"End to End", mymonhistos->getEndToEndHisto()}};
+    for (auto &h : latency_histos) {
+      string item = latency_folder_name + "/" + h.first;
+      _mon->getOnlineMon()->registerTreeItem(item);
+      _mon->getOnlineMon()->registerHisto(item, h.second);
+      _mon->getOnlineMon()->registerMutex(item, mymonhistos->getMutex());
+    }
+    _mon->getOnlineMon()->makeTreeItemSummary(latency_folder_name.c_str());
+
     _mon->getOnlineMon()->makeTreeItemSummary(
         performance_folder_name.c_str()); // make summary page
   }
@@ -6,8 +6,10 @@
  */
 
 #include "MonitorPerformanceHistos.hh"
+#include "eudaq/LatencyStamp.hh"
 
 #include <iostream>
+#include <cmath>
 
 MonitorPerformanceHistos::MonitorPerformanceHistos() {
   _AnalysisTimeHisto =
@@ -17,14 +19,36 @@ MonitorPerformanceHistos::MonitorPerformanceHistos() {
       new TH1I("Clustering Time", "Clustering Time", 400, 0, 0.01);
   _CorrelationTimeHisto =
       new TH1I("Correlation Time", "Correlation Time", 400, 0, 0.02);
+  _ProducerToCollectorHisto = makeLatencyHisto("Producer to Collector Latency");
+  _CollectorHisto = makeLatencyHisto("Collector Latency");
+  _CollectorToMonitorHisto = makeLatencyHisto("Collector to Monitor Latency");
+  _MonitorHisto = makeLatencyHisto("Monitor Latency");
+  _EndToEndHisto = makeLatencyHisto("End to End Latency");
   if ((_FillTimeHisto == NULL) || (_AnalysisTimeHisto == NULL) ||
-      (_ClusteringTimeHisto == NULL) || (_CorrelationTimeHisto == NULL)) {
+      (_ClusteringTimeHisto == NULL) || (_CorrelationTimeHisto == NULL) ||
+      (_ProducerToCollectorHisto == NULL) || (_CollectorHisto == NULL) ||
+      (_CollectorToMonitorHisto == NULL) || (_MonitorHisto == NULL) ||
+      (_EndToEndHisto == NULL)) {
     std::cerr << "MonitorPerformanceHistos:: Error allocating Histograms"
               << std::endl;
     exit(-1); // we bail out, if can't allocate memory
   }
 }
 
+// 20 bins per decade from 1 us to 100 s, so that the tail stays visible
+TH1D *MonitorPerformanceHistos::makeLatencyHisto(const char *name) {
+  const int nbins = 160;
+  double edges[nbins + 1];
+  for (int i = 0; i <= nbins; ++i) {
+    edges[i] = 1e-6 * std::pow(10., i / 20.);
+  }
+  TH1D *h = new TH1D(name, name, nbins, edges);
+  if (h != NULL) {
+    h->GetXaxis()->SetTitle("latency [s]");
+  }
+  return h;
+}
+
 MonitorPerformanceHistos::~MonitorPerformanceHistos() {
   // TODO Auto-generated destructor stub
 }
@@ -34,6 +58,11 @@ void MonitorPerformanceHistos::Write() {
   _FillTimeHisto->Write();
   _ClusteringTimeHisto->Write();
   _CorrelationTimeHisto->Write();
+  _ProducerToCollectorHisto->Write();
+  _CollectorHisto->Write();
+  _CollectorToMonitorHisto->Write();
+  _MonitorHisto->Write();
+  _EndToEndHisto->Write();
 }
 
 void MonitorPerformanceHistos::Fill(SimpleStandardEvent ev) {
@@ -42,6 +71,26 @@ void MonitorPerformanceHistos::Fill(SimpleStandardEvent ev) {
   _FillTimeHisto->Fill(ev.getMonitor_eventfilltime());
   _ClusteringTimeHisto->Fill(ev.getMonitor_clusteringtime());
   _CorrelationTimeHisto->Fill(ev.getMonitor_correlationtime());
+
+  // the event becomes visible with this fill
+  const uint64_t producer = ev.getLatency_stamp(eudaq::LatencyStamp::PRODUCER_SEND);
+  const uint64_t received = ev.getLatency_stamp(eudaq::LatencyStamp::COLLECTOR_RECEIVE);
+  const uint64_t written = ev.getLatency_stamp(eudaq::LatencyStamp::COLLECTOR_WRITE);
+  const uint64_t monitor = ev.getLatency_stamp(eudaq::LatencyStamp::MONITOR_RECEIVE);
+  const uint64_t visible = eudaq::LatencyStamp::Now();
+  // stamps missing or out of order between hosts are not filled
+  if (producer != 0 && received >= producer)
+    _ProducerToCollectorHisto->Fill((received - producer) * 1e-9);
+  if (received != 0 && written >= received)
+    _CollectorHisto->Fill((written - received) * 1e-9);
+  if (written != 0 && monitor >= written)
+    _CollectorToMonitorHisto->Fill((monitor - written) * 1e-9);
+  if (monitor != 0 && visible >= monitor)
+    _MonitorHisto->Fill((visible - monitor) * 1e-9);
+  if (producer != 0 && visible >= producer) {
+    _EndToEndHisto->Fill((visible - producer) * 1e-9);
+    _endToEnd.Record(visible - producer);
+  }
 }
 
 void MonitorPerformanceHistos::Reset() {
@@ -49,4 +98,10 @@ void MonitorPerformanceHistos::Reset() {
   _FillTimeHisto->Reset();
   _ClusteringTimeHisto->Reset();
   _CorrelationTimeHisto->Reset();
+  _ProducerToCollectorHisto->Reset();
+  _CollectorHisto->Reset();
+  _CollectorToMonitorHisto->Reset();
+  _MonitorHisto->Reset();
+  _EndToEndHisto->Reset();
+  _endToEnd.Reset();
 }
@@ -0,0 +1,104 @@
+#include "OccupancyEstimator.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+OccupancyEstimator::OccupancyEstimator(int maxX, int maxY)
+    : _maxX(maxX > 0 ? maxX : 0), _maxY(maxY > 0 ? maxY : 0), _growth(1),
+      _weight(1), _wsum(0), _events(0), _capacity(1 << 16) {}
+
+void OccupancyEstimator::setDecay(double events) {
+  _growth = events > 0 ? std::exp(1. / events) : 1;
+}
+
+void OccupancyEstimator::setCapacity(size_t n) { _capacity = n > 0 ? n : 1; }
+
+void OccupancyEstimator::AddEvent() {
+  _weight *= _growth;
+  _wsum += _weight;
+  _events++;
+  if (_weight > 1e100) {
+    Renormalise();
+  }
+}
+
+void OccupancyEstimator::Fill(int x, int y) {
+  if (x < 0 || x >= _maxX || y < 0 || y >= _maxY) {
+    return;
+  }
+  _counts[x * _maxY + y] += _weight;
+}
+
+double OccupancyEstimator::getOccupancy(int x, int y) const {
+  if (_wsum <= 0 || x < 0 || x >= _maxX || y < 0 || y >= _maxY) {
+    return 0;
+  }
+  auto it = _counts.find(x * _maxY + y);
+  return it == _counts.end() ? 0 : it->second / _wsum;
+}
+
+void OccupancyEstimator::Update(double cut, size_t k, std::vector<Pixel> &hot,
+                                std::vector<double> *all) {
+  hot.clear();
+  if (_wsum <= 0) {
+    return;
+  }
+  _scratch.clear();
+  for (auto it = _counts.begin(); it != _counts.end();) {
+    // with decay, forget pixels whose hits are worth less than a thousandth
+    // of a hit now
+    if (_growth > 1 && it->second < 1e-3 * _weight) {
+      it = _counts.erase(it);
+      continue;
+    }
+    _scratch.emplace_back(it->second, it->first);
+    ++it;
+  }
+  std::greater<std::pair<double, uint32_t>> more_active;
+  if (_scratch.size() > _capacity) {
+    std::nth_element(_scratch.begin(), _scratch.begin() + _capacity,
+                     _scratch.end(), more_active);
+    for (size_t i = _capacity; i < _scratch.size(); ++i) {
+      _counts.erase(_scratch[i].second);
+    }
+    _scratch.resize(_capacity);
+  }
+  if (all != NULL) {
+    all->clear();
+    for (auto &s : _scratch) {
+      all->push_back(s.first / _wsum);
+    }
+  }
+  auto hot_end = std::partition(
+      _scratch.begin(), _scratch.end(),
+      [this, cut](const std::pair<double, uint32_t> &s) {
+        return s.first / _wsum > cut;
+      });
+  size_t nhot = hot_end - _scratch.begin();
+  std::partial_sort(_scratch.begin(), _scratch.begin() + std::min(k, nhot),
+                    hot_end, more_active);
+  hot.reserve(nhot);
+  for (auto it = _scratch.begin(); it != hot_end; ++it) {
+    Pixel p;
+    p.x = it->second / _maxY;
+    p.y = it->second % _maxY;
+    p.occupancy = it->first / _wsum;
+    hot.push_back(p);
+  }
+}
+
+void OccupancyEstimator::Reset() {
+  _counts.clear();
+  _weight = 1;
+  _wsum = 0;
+  _events = 0;
+}
+
+void OccupancyEstimator::Renormalise() {
+  for (auto &c : _counts) {
+    c.second /= _weight;
+  }
+  _wsum /= _weight;
+  _weight = 1;
+}
@@ -26,6 +26,9 @@
 #include "TColor.h"
 #include "TString.h"
 #include "TF1.h"
+#include "TKey.h"
+#include "TGraph.h"
+#include "TDirectory.h"
 //#include "TSystem.h" // for TProcessEventTimer
 // C++ INCLUDES
 #include <iostream>
@@ -40,23 +43,32 @@
 #include <chrono>
 #include <thread>
 #include <memory>
+#include <algorithm>
+#include <iterator>
+#include <future>
+#include <cstdio>
 
 //ONLINE MONITOR Includes
 #include "OnlineMon.hh"
 #include "eudaq/StandardEvent.hh"
 #include "eudaq/StdEventConverter.hh"
 #include "eudaq/FileReader.hh"
+#include "eudaq/LatencyStamp.hh"
 using namespace std;
 
 RootMonitor::RootMonitor(const std::string & runcontrol,
 			 int /*x*/, int /*y*/, int /*w*/, int /*h*/,
-			 const std::string & conffile, const std::string & monname)
-  :eudaq::Monitor(monname, runcontrol), _planesInitialized(false), onlinemon(NULL){
-  onlinemon = new OnlineMonWindow(gClient->GetRoot(),800,600);
-
-  if (onlinemon==NULL){
-    std::cerr<< "Error Allocationg OnlineMonWindow"<<endl;
-    exit(-1);
+			 const std::string & conffile, const std::string & monname,
+			 const bool headless)
+  :eudaq::Monitor(monname, runcontrol), onlinemon(NULL), _reduce(1), _autoReset(false), _offline(false),
+   m_threads(1), m_fill_buffer_max(1000), m_dump_interval(0), m_dump_dir("./"){
+  if (!headless){
+    onlinemon = new OnlineMonWindow(gClient->GetRoot(),800,600);
+
+    if (onlinemon==NULL){
+      std::cerr<< "Error Allocationg OnlineMonWindow"<<endl;
+      exit(-1);
+    }
   }
 
   m_plane_c = 0;
@@ -64,7 +76,7 @@ RootMonitor::RootMonitor(const std::string & runcontrol,
   
   hmCollection = new HitmapCollection();
   corrCollection = new CorrelationCollection();
-  MonitorPerformanceCollection *monCollection =new MonitorPerformanceCollection();
+  monCollection = new MonitorPerformanceCollection();
   eudaqCollection = new EUDAQMonitorCollection();
   paraCollection = new ParaMonitorCollection();
 
@@ -82,7 +94,8 @@ RootMonitor::RootMonitor(const std::string & runcontrol,
   eudaqCollection->setRootMonitor(this);
   paraCollection->setRootMonitor(this);
 
-  onlinemon->setCollections(_colls);
+  if (onlinemon)
+    onlinemon->setCollections(_colls);
 
   //initialize with default configuration
   mon_configdata.SetDefaults();
@@ -106,12 +119,16 @@ RootMonitor::RootMonitor(const std::string & runcontrol,
   previous_event_clustering_time=0;
   previous_event_correlation_time=0;
 
-  onlinemon->SetOnlineMon(this);    
+  if (onlinemon)
+    onlinemon->SetOnlineMon(this);    
 
+  StartWorkers();
 }
 
 RootMonitor::~RootMonitor(){
-  gApplication->Terminate();
+  StopWorkers();
+  if (gApplication)
+    gApplication->Terminate();
 }
 
 OnlineMonWindow* RootMonitor::getOnlineMon() const {
@@ -130,13 +147,22 @@ void RootMonitor::setCorr_planes(const unsigned c_p) {
 }
 
 void RootMonitor::setReduce(const unsigned int red) {
-  onlinemon->setReduce(red);
+  _reduce = red;
+  eudaq::EventSelection sel = GetEventSelection();
+  sel.SetSampling(red);
+  SetEventSelection(sel);
+  if (onlinemon)
+    onlinemon->setReduce(red);
   for (unsigned int i = 0 ; i < _colls.size(); ++i)
   {
     _colls.at(i)->setReduce(red);
   }
 }
 
+void RootMonitor::setOffline(const bool offline) {
+  _offline = offline;
+}
+
 void RootMonitor::setUseTrack_corr(const bool t_c) {
   useTrackCorrelator = t_c;
 }
@@ -159,14 +185,42 @@ void RootMonitor::DoConfigure(){
 }
 
 void RootMonitor::DoTerminate(){
-  gApplication->Terminate();
-}  
+  if (gApplication)
+    gApplication->Terminate();
+}
+
+void RootMonitor::DoStatus(){
+  // latency from the producer until the event is in the histograms
+  const eudaq::LatencyHistogram &lat = monCollection->getMonitorPerformanceHistos()->getEndToEnd();
+  if (lat.GetCount()){
+    lat.ExportTags("VisibleLatency", [this](const std::string &k, const std::string &v){SetStatusTag(k, v);});
+  }
+}
 
 void RootMonitor::DoReceive(eudaq::EventSP evsp) {
-  if(evsp->GetEventN() > 10 && evsp->GetEventN() % onlinemon->getReduce() != 0){
-    return;
+  // the GUI can change reduce while running
+  unsigned int reduce = onlinemon ? onlinemon->getReduce() : _reduce;
+  if(_offline){
+    if(evsp->GetEventN() > 10 && evsp->GetEventN() % reduce != 0){
+      return;
+    }
   }
-  
+  else if(reduce != _reduce){
+    // the DataCollector drops the events before sending them
+    _reduce = reduce;
+    eudaq::EventSelection sel = GetEventSelection();
+    sel.SetSampling(reduce);
+    SetEventSelection(sel);
+  }
+  // hand the event to the workers, wait if they are behind
+  std::unique_lock<std::mutex> lk(m_mtx_in);
+  m_cv_out.wait(lk, [this]{return m_que_in.size() < m_que_in_max;});
+  m_que_in.push_back(evsp);
+  lk.unlock();
+  m_cv_in.notify_one();
+}
+
+bool RootMonitor::AnalyseEvent(eudaq::EventSP evsp, SimpleStandardEvent &simpEv) {
   auto stdev = std::dynamic_pointer_cast<eudaq::StandardEvent>(evsp);
   if(!stdev){
     stdev = eudaq::StandardEvent::MakeShared();
@@ -174,24 +228,27 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
   }
   
   uint32_t ev_plane_c = stdev->NumPlanes();
-  if(m_ev_rec_n < 10){
-    m_ev_rec_n ++;
-    if(ev_plane_c > m_plane_c){
-      m_plane_c = ev_plane_c;
+  {
+    std::lock_guard<std::mutex> lk(m_mtx_plane_c);
+    if(m_ev_rec_n < 10){
+      m_ev_rec_n ++;
+      if(ev_plane_c > m_plane_c){
+        m_plane_c = ev_plane_c;
+      }
+      return false;
+    }
+    if(ev_plane_c != m_plane_c){
+      std::cout<< "Event #"<< evsp->GetEventN()<< " has "<<ev_plane_c<<" plane(s), while we expect "<< m_plane_c <<" plane(s).  (Event is skipped)" <<std::endl;
+      return false;
     }
-    return;
   }
 
-  if(ev_plane_c != m_plane_c){
-    std::cout<< "Event #"<< evsp->GetEventN()<< " has "<<ev_plane_c<<" plane(s), while we expect "<< m_plane_c <<" plane(s).  (Event is skipped)" <<std::endl;
-    return;
-  }
-    
-  my_event_processing_time.Start(true);
+  TStopwatch processing_time;
+  TStopwatch clustering_time;
+  processing_time.Start(true);
 
   uint32_t num = stdev->NumPlanes();
 
-  SimpleStandardEvent simpEv;
   // store the processing time of the previous EVENT, as we can't track this during the  processing
   simpEv.setMonitor_eventanalysistime(previous_event_analysis_time);
   simpEv.setMonitor_eventfilltime(previous_event_fill_time);
@@ -200,6 +257,12 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
   // add some info into the simple event header
   simpEv.setEvent_number(stdev->GetEventNumber());
   simpEv.setEvent_timestamp(stdev->GetTimestampBegin());
+  // the Monitor stamps events that carry the stamps of the DataCollector
+  if (evsp->HasTag(eudaq::LatencyStamp::TagName(eudaq::LatencyStamp::MONITOR_RECEIVE))){
+    for (int hop = 0; hop < eudaq::LatencyStamp::NUM_HOPS; ++hop){
+      simpEv.setLatency_stamp(hop, eudaq::LatencyStamp::Get(*evsp, eudaq::LatencyStamp::Hop(hop)));
+    }
+  }
     
   for (unsigned int i = 0; i < num;i++){
     const eudaq::StandardPlane & plane = stdev->GetPlane(i);
@@ -245,26 +308,26 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
     }
     simpEv.addPlane(simpPlane);
   }
-  my_event_inner_operations_time.Start(true);
+  clustering_time.Start(true);
   simpEv.doClustering();
-  my_event_inner_operations_time.Stop();
-  previous_event_clustering_time = my_event_inner_operations_time.RealTime();
-
-  if(!_planesInitialized){
-      std::this_thread::sleep_for(std::chrono::seconds(1));
-      _planesInitialized = true;
-  }
+  clustering_time.Stop();
+  previous_event_clustering_time = clustering_time.RealTime();
 
   //stop the Stop watch
-  my_event_processing_time.Stop();
-  previous_event_analysis_time=my_event_processing_time.RealTime();
-  //Filling
-  my_event_processing_time.Start(true); //start the stopwatch again
+  processing_time.Stop();
+  previous_event_analysis_time = processing_time.RealTime();
+  return true;
+}
+
+void RootMonitor::FillEvent(const SimpleStandardEvent &simpEv) {
+  TStopwatch fill_time;
+  TStopwatch correlation_time;
+  fill_time.Start(true);
   for (unsigned int i = 0 ; i < _colls.size(); ++i)
     {
       if (_colls.at(i) == corrCollection)
         {
-          my_event_inner_operations_time.Start(true);
+          correlation_time.Start(true);
           if (getUseTrack_corr() == true)
             {
               tracksPerEvent = corrCollection->FillWithTracks(simpEv);
@@ -273,8 +336,8 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
             }
           else
             _colls.at(i)->Fill(simpEv);
-          my_event_inner_operations_time.Stop();
-          previous_event_correlation_time = my_event_inner_operations_time.RealTime();
+          correlation_time.Stop();
+          previous_event_correlation_time = correlation_time.RealTime();
         }
       else
         _colls.at(i)->Fill(simpEv);
@@ -282,25 +345,244 @@ void RootMonitor::DoReceive(eudaq::EventSP evsp) {
       // CollType is used to check which kind of Collection we are having
       if (_colls.at(i)->getCollectionType()==HITMAP_COLLECTION_TYPE) // Calculate is only implemented for HitMapCollections
         {
-          _colls.at(i)->Calculate(stdev->GetEventNumber());
+          _colls.at(i)->Calculate(simpEv.getEvent_number());
         }
     }
 
-  onlinemon->setEventNumber(stdev->GetEventNumber());
-  onlinemon->increaseAnalysedEventsCounter();
+  if (onlinemon){
+    onlinemon->setEventNumber(simpEv.getEvent_number());
+    onlinemon->increaseAnalysedEventsCounter();
+  }
     
-  my_event_processing_time.Stop();
-  previous_event_fill_time=my_event_processing_time.RealTime();
+  fill_time.Stop();
+  previous_event_fill_time = fill_time.RealTime();
+}
+
+void RootMonitor::FlushFillBuffers() {
+  std::lock_guard<std::mutex> lk_fill(m_mtx_fill);
+  DrainFillBuffers();
+}
+
+void RootMonitor::DrainFillBuffers() {
+  std::vector<SimpleStandardEvent> events;
+  for (auto &buf: m_fill_buffers){
+    std::lock_guard<std::mutex> lk(buf->mtx);
+    events.insert(events.end(), std::make_move_iterator(buf->events.begin()),
+                  std::make_move_iterator(buf->events.end()));
+    buf->events.clear();
+    buf->cv.notify_all();
+  }
+  // the workers finish in any order, fill in event order
+  std::stable_sort(events.begin(), events.end(),
+                   [](const SimpleStandardEvent &a, const SimpleStandardEvent &b){
+                     return a.getEvent_number() < b.getEvent_number();
+                   });
+  for (auto &ev: events){
+    FillEvent(ev);
+  }
+  for (auto coll: _colls){
+    coll->Flush();
+  }
+}
+
+void RootMonitor::WorkerLoop(FillBuffer *buf) {
+  while(true){
+    eudaq::EventSP evsp;
+    {
+      std::unique_lock<std::mutex> lk(m_mtx_in);
+      m_cv_in.wait(lk, [this]{return m_exit || !m_que_in.empty();});
+      if(m_que_in.empty()){
+        return;
+      }
+      evsp = m_que_in.front();
+      m_que_in.pop_front();
+      m_busy ++;
+    }
+    m_cv_out.notify_all();
+
+    SimpleStandardEvent simpEv;
+    bool analysed = AnalyseEvent(evsp, simpEv);
+    std::unique_lock<std::mutex> lk_buf(buf->mtx);
+    if(analysed){
+      buf->events.push_back(std::move(simpEv));
+    }
+    {
+      // the event is in the buffer, WaitWorkersIdle need not wait for the fill
+      std::lock_guard<std::mutex> lk(m_mtx_in);
+      m_busy --;
+    }
+    m_cv_out.notify_all();
+    // the histograms are only filled by the GUI timer, if it does not keep
+    // up the worker waits and DoReceive in turn blocks the receiver
+    buf->cv.wait(lk_buf, [this, buf]{
+        return buf->stop || buf->events.size() < m_fill_buffer_max;});
+  }
+}
+
+void RootMonitor::StartWorkers() {
+  m_exit = false;
+  m_busy = 0;
+  m_que_in_max = 4 * m_threads;
+  {
+    std::lock_guard<std::mutex> lk(m_mtx_fill);
+    m_fill_buffers.clear();
+    for (unsigned int i = 0; i < m_threads; ++i){
+      m_fill_buffers.emplace_back(new FillBuffer);
+    }
+  }
+  for (unsigned int i = 0; i < m_threads; ++i){
+    m_workers.emplace_back(&RootMonitor::WorkerLoop, this, m_fill_buffers.at(i).get());
+  }
+}
+
+void RootMonitor::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lk(m_mtx_in);
+    m_exit = true;
+  }
+  m_cv_in.notify_all();
+  {
+    std::lock_guard<std::mutex> lk(m_mtx_fill);
+    for (auto &buf: m_fill_buffers){
+      std::lock_guard<std::mutex> lk_buf(buf->mtx);
+      buf->stop = true;
+      buf->cv.notify_all();
+    }
+  }
+  for (auto &t: m_workers){
+    if(t.joinable()){
+      t.join();
+    }
+  }
+  m_workers.clear();
+  FlushFillBuffers();
+}
+
+void RootMonitor::WaitWorkersIdle() {
+  std::unique_lock<std::mutex> lk(m_mtx_in);
+  m_cv_out.wait(lk, [this]{return m_que_in.empty() && m_busy == 0;});
+}
+
+void RootMonitor::setThreads(const unsigned int n) {
+  StopWorkers();
+  m_threads = n;
+  if (m_threads == 0){
+    m_threads = std::thread::hardware_concurrency();
+  }
+  if (m_threads == 0){
+    m_threads = 1;
+  }
+  StartWorkers();
+}
+
+void RootMonitor::setDump(const unsigned int interval, const std::string &dir) {
+  m_dump_interval = interval;
+  m_dump_dir = dir;
+  if (!m_dump_dir.empty() && m_dump_dir.back() != '/')
+    m_dump_dir += "/";
+  m_next_dump = std::chrono::steady_clock::now() + std::chrono::seconds(m_dump_interval);
+}
+
+void RootMonitor::DumpIfDue() {
+  if (m_dump_interval == 0 || std::chrono::steady_clock::now() < m_next_dump)
+    return;
+  m_next_dump = std::chrono::steady_clock::now() + std::chrono::seconds(m_dump_interval);
+  WriteDump();
+}
+
+static std::string jsonEscape(const std::string &in) {
+  std::string out;
+  for (char c: in){
+    if (c == '"' || c == '\\')
+      out += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20)
+      out += c;
+  }
+  return out;
+}
+
+// one line per histogram or graph found below dir
+static void writeJsonSummary(TDirectory *dir, const std::string &path,
+                             std::ostream &os, bool &first) {
+  TIter next(dir->GetListOfKeys());
+  while (TKey *key = static_cast<TKey*>(next())){
+    std::string name = path + key->GetName();
+    TObject *obj = key->ReadObj();
+    if (TDirectory *sub = dynamic_cast<TDirectory*>(obj)){
+      writeJsonSummary(sub, name + "/", os, first);
+      continue;
+    }
+    std::ostringstream entry;
+    if (TH1 *h = dynamic_cast<TH1*>(obj)){
+      entry << "{\"name\":\"" << jsonEscape(name) << "\",\"class\":\"" << h->ClassName()
+            << "\",\"entries\":" << h->GetEntries() << ",\"mean\":" << h->GetMean()
+            << ",\"rms\":" << h->GetRMS() << "}";
+    }
+    else if (TGraph *g = dynamic_cast<TGraph*>(obj)){
+      entry << "{\"name\":\"" << jsonEscape(name) << "\",\"class\":\"" << g->ClassName()
+            << "\",\"points\":" << g->GetN();
+      if (g->GetN() > 0)
+        entry << ",\"last_x\":" << g->GetX()[g->GetN() - 1]
+              << ",\"last_y\":" << g->GetY()[g->GetN() - 1];
+      entry << "}";
+    }
+    delete obj;
+    if (entry.str().empty())
+      continue;
+    os << (first ? "\n  " : ",\n  ") << entry.str();
+    first = false;
+  }
+}
+
+void RootMonitor::WriteDump() {
+  std::lock_guard<std::mutex> lk_fill(m_mtx_fill);
+  DrainFillBuffers();
+
+  char out[255];
+  sprintf(out, "run%d_snapshot", GetRunNumber());
+  std::string base = m_dump_dir + out;
+  // written under a temporary name, so readers never see a partial file
+  std::string tmpname = base + ".root.tmp";
+  TFile *f = new TFile(tmpname.c_str(), "RECREATE");
+  if (f->IsZombie()){
+    std::cerr << "OnlineMon: unable to write snapshot " << tmpname << std::endl;
+    delete f;
+    return;
+  }
+  for (unsigned int i = 0 ; i < _colls.size(); ++i)
+  {
+    f->cd();
+    _colls.at(i)->Write(f);
+  }
+
+  std::ofstream json((base + ".json.tmp").c_str());
+  bool first = true;
+  json << "{\"run\":" << GetRunNumber() << ",\"histograms\":[";
+  writeJsonSummary(f, "", json, first);
+  json << "\n]}\n";
+  json.close();
+  f->Close();
+  delete f;
+
+  std::rename(tmpname.c_str(), (base + ".root").c_str());
+  std::rename((base + ".json.tmp").c_str(), (base + ".json").c_str());
 }
 
 void RootMonitor::autoReset(const bool reset) {
-  onlinemon->setAutoReset(reset);
+  _autoReset = reset;
+  if (onlinemon)
+    onlinemon->setAutoReset(reset);
 }
 
 void RootMonitor::DoStopRun()
 {
-  m_plane_c = 0;
-  m_ev_rec_n = 0;
+  WaitWorkersIdle();
+  FlushFillBuffers();
+  {
+    std::lock_guard<std::mutex> lk(m_mtx_plane_c);
+    m_plane_c = 0;
+    m_ev_rec_n = 0;
+  }
 
   if (_writeRoot)
   {
@@ -311,17 +593,27 @@ void RootMonitor::DoStopRun()
     }
     f->Close();
   }
-  onlinemon->UpdateStatus("Run stopped");
+  if (m_dump_interval > 0)
+    WriteDump();
+  if (onlinemon)
+    onlinemon->UpdateStatus("Run stopped");
 }
 
 void RootMonitor::DoStartRun() {
-  m_plane_c = 0;
-  m_ev_rec_n = 0;
+  // events left over from the previous run must not end up in this one
+  WaitWorkersIdle();
+  FlushFillBuffers();
+  {
+    std::lock_guard<std::mutex> lk(m_mtx_plane_c);
+    m_plane_c = 0;
+    m_ev_rec_n = 0;
+  }
   uint32_t runnumber = GetRunNumber();
 
-  if (onlinemon->getAutoReset())
+  if (onlinemon ? onlinemon->getAutoReset() : _autoReset)
   {
-    onlinemon->UpdateStatus("Resetting..");
+    if (onlinemon)
+      onlinemon->UpdateStatus("Resetting..");
     for (unsigned int i = 0 ; i < _colls.size(); ++i)
     {
       if (_colls.at(i) != NULL)
@@ -329,19 +621,21 @@ void RootMonitor::DoStartRun() {
     }
   }
 
-  onlinemon->UpdateStatus("Starting run..");
+  if (onlinemon)
+    onlinemon->UpdateStatus("Starting run..");
   char out[255];
   sprintf(out, "run%d.root", runnumber);
   rootfilename = std::string(out);
-  onlinemon->setRunNumber(runnumber);
-  onlinemon->setRootFileName(rootfilename);
-
-  // Reset the planes initializer on new run start:
-  _planesInitialized = false;
+  if (onlinemon){
+    onlinemon->setRunNumber(runnumber);
+    onlinemon->setRootFileName(rootfilename);
+  }
+  m_next_dump = std::chrono::steady_clock::now() + std::chrono::seconds(m_dump_interval);
 }
 
 void RootMonitor::setUpdate(const unsigned int up) {
-  onlinemon->setUpdate(up);
+  if (onlinemon)
+    onlinemon->setUpdate(up);
 }
 
 //sets the location for the snapshots
@@ -391,6 +685,7 @@ int main(int argc, const char ** argv) {
   eudaq::Option<unsigned>        corr_planes(op, "cp", "corr_planes",  5, "Minimum amount of planes for track reconstruction in the correlation");
   eudaq::Option<bool>            track_corr(op, "tc", "track_correlation", false, "Using (EXPERIMENTAL) track correlation(true) or cluster correlation(false)");
   eudaq::Option<int>             update(op, "u", "update",  1000, "update every ms");
+  eudaq::Option<unsigned>        threads(op, "j", "threads",  0, "number of analysis threads (0: one per core)");
   eudaq::Option<uint32_t>        event_id_low(op, "e", "event_id_low",  0, "running is offlinemode - analyse begin event id <num>");
   eudaq::Option<uint32_t>        event_id_high(op, "E", "event_id_high", 0xffffffff, "running is offlinemode - analyse until event id <num>");
   eudaq::Option<uint32_t>        event_amount_max(op, "ea", "event_amount_max", 0xffffffff, "running is offlinemode - analyse until reach events amount");
@@ -400,6 +695,10 @@ int main(int argc, const char ** argv) {
   eudaq::Option<std::string>     monitorname(op, "t", "monitor_name","StdEventMonitor", "StdEventMonitor","Name for onlinemon");	
   eudaq::OptionFlag do_rootatend (op, "rf","root","Write out root-file after each run");
   eudaq::OptionFlag do_resetatend (op, "rs","reset","Reset Histograms when run stops");
+  eudaq::OptionFlag do_headless (op, "hl","headless","Run without GUI, e.g. on hosts without X");
+  eudaq::Option<unsigned>        dump_interval(op, "di", "dump_interval", 0, "seconds",
+                                               "Write ROOT and JSON snapshots of all histograms every <seconds> (0: never)");
+  eudaq::Option<std::string>     dump_dir(op, "dd", "dump_dir", "./", "directory", "Directory for the snapshots");
   
   try {
     op.Parse(argv);
@@ -416,10 +715,17 @@ int main(int argc, const char ** argv) {
   if(!rctrl.IsSet())
     rctrl.SetValue("tcp://localhost:44000");
     
-  TApplication theApp("App", &argc, const_cast<char**>(argv),0,0);
+  bool headless = do_headless.IsSet();
+  std::unique_ptr<TApplication> theApp;
+  if(headless){
+    gROOT->SetBatch(kTRUE);
+  }
+  else{
+    theApp.reset(new TApplication("App", &argc, const_cast<char**>(argv),0,0));
+  }
   RootMonitor mon(rctrl.Value(),
 		  100, 0, 1400, 700,
-                  configfile.Value(), monitorname.Value());
+                  configfile.Value(), monitorname.Value(), headless);
   mon.setWriteRoot(do_rootatend.IsSet());
   mon.autoReset(do_resetatend.IsSet());
   mon.setReduce(reduce.Value());
@@ -427,6 +733,9 @@ int main(int argc, const char ** argv) {
   mon.setCorr_width(corr_width.Value());
   mon.setCorr_planes(corr_planes.Value());
   mon.setUseTrack_corr(track_corr.Value());
+  mon.setThreads(threads.Value());
+  mon.setOffline(offline);
+  mon.setDump(dump_interval.Value(), dump_dir.Value());
   eudaq::Monitor *m = dynamic_cast<eudaq::Monitor*>(&mon);
   std::future<uint64_t> fut_async_rd;
 
@@ -443,7 +752,21 @@ int main(int argc, const char ** argv) {
     m->Connect();
   }
 
-  theApp.Run(); //execute
+  if(!headless){
+    theApp->Run(); //execute
+  }
+  else{
+    // without the GUI timer, drain the analysed events and dump from here
+    auto tick = std::chrono::milliseconds(update.Value());
+    while(fut_async_rd.valid() ?
+          fut_async_rd.wait_for(tick) != std::future_status::ready :
+          m->IsConnected()){
+      if(!fut_async_rd.valid())
+        std::this_thread::sleep_for(tick);
+      mon.FlushFillBuffers();
+      mon.DumpIfDue();
+    }
+  }
   if(fut_async_rd.valid())
     fut_async_rd.get();
   return 0;
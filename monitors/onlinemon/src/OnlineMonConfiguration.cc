@@ -153,6 +153,23 @@ int OnlineMonConfiguration::ReadConfigurationFile() {
           if (hotpixelcut <= 0) {
             cerr << " Warning Illegal HotPixelCut used " << endl;
           }
+        } else if (key.compare("HotPixelDecay") == 0) {
+          hotpixeldecay = StringToNumber<float>(value);
+          if (hotpixeldecay < 0) {
+            cerr << " Warning Illegal HotPixelDecay used " << endl;
+          }
+        } else if (key.compare("HotPixelUpdate") == 0) {
+          hotpixelupdate = StringToNumber<unsigned int>(value);
+          if (hotpixelupdate <= 0) {
+            cerr << " Warning Illegal HotPixelUpdate used " << endl;
+          }
+        } else if (key.compare("HotPixelTopK") == 0) {
+          hotpixeltopk = StringToNumber<unsigned int>(value);
+        } else if (key.compare("HotPixelMaxPixels") == 0) {
+          hotpixelmaxpixels = StringToNumber<unsigned int>(value);
+          if (hotpixelmaxpixels <= 0) {
+            cerr << " Warning Illegal HotPixelMaxPixels used " << endl;
+          }
         } else {
           cerr << "Unknown Key " << key << endl;
         }
@@ -197,6 +214,10 @@ void OnlineMonConfiguration::SetDefaults() {
 
   // hotpixel settings
   hotpixelcut = 0.01;
+  hotpixeldecay = 0;
+  hotpixelupdate = 1000;
+  hotpixeltopk = 50;
+  hotpixelmaxpixels = 65536;
 
   // correl cluster settings
   correl_minclustersize = 1;
@@ -216,6 +237,39 @@ void OnlineMonConfiguration::setHotpixelcut(double hotpixelcut) {
   this->hotpixelcut = hotpixelcut;
 }
 
+double OnlineMonConfiguration::getHotpixeldecay() const {
+  return hotpixeldecay;
+}
+
+void OnlineMonConfiguration::setHotpixeldecay(double hotpixeldecay) {
+  this->hotpixeldecay = hotpixeldecay;
+}
+
+unsigned int OnlineMonConfiguration::getHotpixelupdate() const {
+  return hotpixelupdate;
+}
+
+void OnlineMonConfiguration::setHotpixelupdate(unsigned int hotpixelupdate) {
+  this->hotpixelupdate = hotpixelupdate;
+}
+
+unsigned int OnlineMonConfiguration::getHotpixeltopk() const {
+  return hotpixeltopk;
+}
+
+void OnlineMonConfiguration::setHotpixeltopk(unsigned int hotpixeltopk) {
+  this->hotpixeltopk = hotpixeltopk;
+}
+
+unsigned int OnlineMonConfiguration::getHotpixelmaxpixels() const {
+  return hotpixelmaxpixels;
+}
+
+void OnlineMonConfiguration::setHotpixelmaxpixels(
+    unsigned int hotpixelmaxpixels) {
+  this->hotpixelmaxpixels = hotpixelmaxpixels;
+}
+
 void OnlineMonConfiguration::setMimosa26_section_boundary(
     unsigned int mimosa26_section_boundary) {
   this->mimosa26_section_boundary = mimosa26_section_boundary;
@@ -257,6 +311,10 @@ void OnlineMonConfiguration::PrintConfiguration() {
   cout << "Clusterizer Settings" << endl;
   cout << "HotPixelFinder Settings" << endl;
   cout << "HotPixelCut         : " << hotpixelcut << endl;
+  cout << "HotPixelDecay       : " << hotpixeldecay << endl;
+  cout << "HotPixelUpdate      : " << hotpixelupdate << endl;
+  cout << "HotPixelTopK        : " << hotpixeltopk << endl;
+  cout << "HotPixelMaxPixels   : " << hotpixelmaxpixels << endl;
   cout << endl;
   cout << "Mimosa26 Settings" << endl;
   cout << "Mimosa26_max_sections     : " << mimosa26_max_sections << endl;
@@ -10,6 +10,7 @@
 // C++ includes
 #include <iostream>
 #include <sstream>
+#include <utility>
 #include "OnlineMonWindow.hh"
 
 #include "eudaq/Config.hh"
@@ -35,7 +36,7 @@ using namespace std;
 // the constructor
 OnlineMonWindow::OnlineMonWindow(const TGWindow *p, UInt_t w, UInt_t h)
     : TGMainFrame(p, w, h, kVerticalFrame), _eventnum(0), _runnum(0),
-      _analysedEvents(0) {
+      _analysedEvents(0), rmon(NULL) {
 
   // init snapshot counter
   snapshot_sequence = 0;
@@ -336,12 +337,58 @@ void OnlineMonWindow::registerMutex(std::string tree, std::mutex *m){
   _mutexMap[tree] = m;
 }
 
+// cheap fingerprint of a histogram or graph, to skip redrawing unchanged ones
+static std::pair<double, int> drawSignature(TNamed *hg) {
+  TH1 *h = dynamic_cast<TH1 *>(hg);
+  if (h) {
+    return std::make_pair(h->GetEntries(), h->GetNcells());
+  }
+  TGraph *g = dynamic_cast<TGraph *>(hg);
+  if (g && g->GetN() > 0) {
+    return std::make_pair(g->GetY()[g->GetN() - 1], g->GetN());
+  }
+  return std::make_pair(0., 0);
+}
+
 void OnlineMonWindow::autoUpdate() {
+  if (rmon != NULL) {
+    rmon->FlushFillBuffers();
+    rmon->DumpIfDue();
+  }
   _reduceUpdate++;
   unsigned int activeHistoSize = _activeHistos.size();
-  if (activeHistoSize && _reduceUpdate > activeHistoSize){
+  // a slow redraw pushes the next one further out
+  if (activeHistoSize && _reduceUpdate > activeHistoSize &&
+      std::chrono::steady_clock::now() >= _nextRedraw) {
+    auto start = std::chrono::steady_clock::now();
     TCanvas *fCanvas = ECvs_right->GetCanvas();
     for (unsigned int i = 0; i < activeHistoSize; ++i) {
+      std::string tree = _activeHistos.at(i);
+      TNamed *hg = _hitmapMap[tree];
+      if (!hg) {
+        continue;
+      }
+      // copy the histogram while holding its lock, render the copy without
+      std::mutex mu_dummy;
+      std::mutex *mu = &mu_dummy;
+      auto it = _mutexMap.find(tree);
+      if(it != _mutexMap.end())
+	mu=it->second;
+      TNamed *snap = NULL;
+      std::pair<double, int> sig;
+      {
+        std::lock_guard<std::mutex> lck(*mu);
+        sig = drawSignature(hg);
+        auto drawn = _drawnMap.find(tree);
+        if (drawn != _drawnMap.end() && drawn->second == sig) {
+          continue;
+        }
+        snap = static_cast<TNamed *>(hg->Clone());
+      }
+      TH1 *h = dynamic_cast<TH1 *>(snap);
+      if (h) {
+        h->SetDirectory(0);
+      }
       if(activeHistoSize ==1){
 	fCanvas->cd();
 	fCanvas->Clear();
@@ -350,27 +397,12 @@ void OnlineMonWindow::autoUpdate() {
 	fCanvas->GetPad(i+1)->Clear();
 	fCanvas->cd(i + 1);
       }
-      std::string tree = _activeHistos.at(i);
-      TNamed *hg = _hitmapMap[tree];
-      if(hg) {
-	TH1 *h = dynamic_cast<TH1 *> (hg);
-	std::mutex mu_dummy;
-	std::mutex *mu = &mu_dummy;
-	auto it = _mutexMap.find(tree);
-	if(it != _mutexMap.end())
-	  mu=it->second;
-	if(h){
-	  std::lock_guard<std::mutex> lck(*mu);
-	  h->Draw(_hitmapOptions[tree].c_str());
-	  gPad->Update();
-	}
-	TGraph *g = dynamic_cast<TGraph *> (hg);
-	if(g){
-	  std::lock_guard<std::mutex> lck(*mu);
-	  g->Draw(_hitmapOptions[tree].c_str());
-	  gPad->Update();
-	}
-      }
+      snap->Draw(_hitmapOptions[tree].c_str());
+      gPad->Update();
+      // the pad no longer shows the previous copy
+      delete _snapshotMap[tree];
+      _snapshotMap[tree] = snap;
+      _drawnMap[tree] = sig;
     }
     UpdateEventNumber(_eventnum);
     UpdateRunNumber(_runnum);
@@ -379,7 +411,18 @@ void OnlineMonWindow::autoUpdate() {
     MapSubwindows();
     MapWindow();
     _reduceUpdate = 0;
+    _nextRedraw = std::chrono::steady_clock::now() +
+                  2 * (std::chrono::steady_clock::now() - start);
+  }
+}
+
+void OnlineMonWindow::clearSnapshots() {
+  for (auto &snap : _snapshotMap) {
+    delete snap.second;
   }
+  _snapshotMap.clear();
+  _drawnMap.clear();
+  _nextRedraw = std::chrono::steady_clock::now();
 }
 
 
@@ -403,6 +446,7 @@ void OnlineMonWindow::actorMenu(TGListTreeItem * /*item*/, Int_t btn, Int_t x,
 void OnlineMonWindow::actor(TGListTreeItem *item, Int_t /*btn*/) {
   TCanvas *fCanvas = ECvs_right->GetCanvas();
   fCanvas->Clear();
+  clearSnapshots();
 
   std::string tree = _treeBackMap[item];
 
@@ -64,6 +64,16 @@ void SimpleStandardEvent::setMonitor_eventcorrelationtime(
   this->monitor_correlationtime = monitor_correlationtime;
 }
 
+uint64_t SimpleStandardEvent::getLatency_stamp(unsigned int hop) const {
+  return hop < latency_stamps.size() ? latency_stamps[hop] : 0;
+}
+
+void SimpleStandardEvent::setLatency_stamp(unsigned int hop, uint64_t ns) {
+  if (hop >= latency_stamps.size())
+    latency_stamps.resize(hop + 1, 0);
+  latency_stamps[hop] = ns;
+}
+
 void SimpleStandardEvent::doClustering() {
   for (int plane = 0; plane < getNPlanes(); plane++) {
     _planes.at(plane).doClustering();
@@ -7,6 +7,8 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <cstdint>
 #include "include/SimpleStandardPlane.hh"
 
 SimpleStandardPlane::SimpleStandardPlane(const std::string &name, const int id,
@@ -96,91 +98,82 @@ void SimpleStandardPlane::reducePixels(const int reduceX, const int reduceY) {
 }
 
 void SimpleStandardPlane::doClustering() {
-  int nClusters = 0;
-  std::vector<int> clusterNumber;
-  const int NOCLUSTER = -1000;
-  const unsigned int minXDistance = 1;
-  const unsigned int minYDistance = 1;
-  const unsigned int npixels_hit = _hits.size();
-  bool continue_flag;
-  clusterNumber.assign(npixels_hit, NOCLUSTER);
-
   // which planes to cluster, reject planes of Type Fortis
   if (is_FORTIS) {
     return;
   }
 
-  if (npixels_hit > 1) // (npixels_hit < 2000 ))
-  {
-    std::sort(_hits.begin(), _hits.end(), SortHitsByXY());
-    for (unsigned int aPixel = 0; aPixel < npixels_hit; aPixel++) {
-      continue_flag = true;
-      const SimpleStandardHit &aPix = _hits.at(aPixel);
-      for (unsigned int bPixel = aPixel + 1; bPixel < npixels_hit; bPixel++) {
-        if (continue_flag != true)
-          break;
-        const SimpleStandardHit &bPix = _hits.at(bPixel);
-        unsigned int xDist = abs(aPix.getX() - bPix.getX());
-        unsigned int yDist = abs(aPix.getY() - bPix.getY());
-
-        if ((xDist <= minXDistance) &&
-            (yDist <= minYDistance)) { // this means they are neighbors in
-                                       // x-direction && / this means they are
-                                       // neighbors in y-direction
-          if ((clusterNumber.at(aPixel) == NOCLUSTER) &&
-              clusterNumber.at(bPixel) == NOCLUSTER) { // none of these pixels
-                                                       // have been assigned to
-                                                       // a cluster
-            //++nClusters;
-            clusterNumber.at(aPixel) = ++nClusters;
-            clusterNumber.at(bPixel) = nClusters;
-          } else if ((clusterNumber.at(aPixel) == NOCLUSTER) &&
-                     (clusterNumber.at(bPixel) !=
-                      NOCLUSTER)) { // b was assigned already, a not
-            clusterNumber.at(aPixel) = clusterNumber.at(bPixel);
-          } else if ((clusterNumber.at(aPixel) != NOCLUSTER) &&
-                     (clusterNumber.at(bPixel) ==
-                      NOCLUSTER)) { // a was assigned already, b not
-            clusterNumber.at(bPixel) = clusterNumber.at(aPixel);
-          } else { // both pixels have a cluster number already
-            int min =
-                std::min(clusterNumber.at(aPixel), clusterNumber.at(bPixel));
-            clusterNumber.at(aPixel) = min;
-            clusterNumber.at(bPixel) = min;
-          }
-        } else { // these pixels are not neighbored
-          continue_flag = false;
-        }
-      } // inner for loop
-    } // outer for loop
-    for (unsigned int aPixel = 0; aPixel < npixels_hit; aPixel++)
-      if (clusterNumber.at(aPixel) == NOCLUSTER) {
-        ++nClusters;
-        clusterNumber.at(aPixel) = nClusters;
+  // Connected components with union-find: every hit is looked up in a
+  // sparse occupancy map and merged with its already known 8-neighbours,
+  // so the cost is linear in the number of hits.
+  const unsigned int npixels_hit = _hits.size();
+  if (npixels_hit == 0) {
+    return;
+  }
+  std::vector<unsigned int> parent(npixels_hit);
+  for (unsigned int i = 0; i < npixels_hit; i++) {
+    parent[i] = i;
+  }
+  auto find = [&parent](unsigned int i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+  auto merge = [&parent, &find](unsigned int a, unsigned int b) {
+    a = find(a);
+    b = find(b);
+    if (a < b) {
+      parent[b] = a;
+    } else if (b < a) {
+      parent[a] = b;
+    }
+  };
+  auto key = [](int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+  };
+
+  std::unordered_map<uint64_t, unsigned int> occupancy;
+  occupancy.reserve(2 * npixels_hit);
+  for (unsigned int i = 0; i < npixels_hit; i++) {
+    const SimpleStandardHit &hit = _hits[i];
+    auto ins = occupancy.emplace(key(hit.getX(), hit.getY()), i);
+    if (!ins.second) { // same pixel reported twice
+      merge(ins.first->second, i);
+    }
+  }
+  // half of the 8-neighbourhood is enough, the other half is covered from
+  // the neighbour's side
+  static const int neighbours[4][2] = {{1, -1}, {1, 0}, {1, 1}, {0, 1}};
+  for (unsigned int i = 0; i < npixels_hit; i++) {
+    const SimpleStandardHit &hit = _hits[i];
+    for (auto &d : neighbours) {
+      auto it = occupancy.find(key(hit.getX() + d[0], hit.getY() + d[1]));
+      if (it != occupancy.end()) {
+        merge(i, it->second);
       }
-  } else { // You can't use the clustering algorithm with only one pixel
-    if (npixels_hit == 1)
-      clusterNumber.at(0) = 1;
+    }
   }
 
-  std::set<int> clusterSet(clusterNumber.begin(), clusterNumber.end());
-
-  nClusters = clusterSet.size();
-
-  std::set<int>::iterator it;
-  for (it = clusterSet.begin(); it != clusterSet.end(); ++it) {
-    SimpleStandardCluster cluster;
-    for (unsigned int i = 0; i < npixels_hit; i++) {
-      if (clusterNumber.at(i) == *it) { // Put only these pixels in that
-                                        // ClusterCollection that belong to that
-                                        // cluster
-        cluster.addPixel(_hits.at(i));
-      }
+  // roots are the lowest hit index of each cluster, number them in order
+  std::vector<int> clusterNumber(npixels_hit, -1);
+  int nClusters = 0;
+  for (unsigned int i = 0; i < npixels_hit; i++) {
+    unsigned int root = find(i);
+    if (clusterNumber[root] < 0) {
+      clusterNumber[root] = nClusters++;
     }
-    _clusters.push_back(cluster);
+    clusterNumber[i] = clusterNumber[root];
+  }
+  const size_t firstCluster = _clusters.size();
+  _clusters.resize(firstCluster + nClusters);
+  for (unsigned int i = 0; i < npixels_hit; i++) {
+    _clusters[firstCluster + clusterNumber[i]].addPixel(_hits[i]);
   }
-  // if we have a mimosa, we need to fill the section information
 
+  // if we have a mimosa, we need to fill the section information
   if (is_MIMOSA26) {
     for (unsigned int mycluster = 0; mycluster < _clusters.size();
          mycluster++) {
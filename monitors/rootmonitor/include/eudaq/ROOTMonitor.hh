@@ -6,8 +6,17 @@
 # include "RQ_OBJECT.h"
 #endif
 
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+class TH1;
+class TH2;
 class TH1D;
+class TProfile;
 class TGraph;
+class TGraph2D;
 
 namespace eudaq {
   class ROOTMonitor : public Monitor {
@@ -15,8 +24,11 @@ namespace eudaq {
     RQ_OBJECT(NAME)
   public:
     ROOTMonitor(const std::string & name, const std::string & title, const std::string & runcontrol);
+    ~ROOTMonitor() override;
 
     void LoadRAWFileAsync(const char* path);
+    /// Move the fills of all threads into the monitored objects
+    void FlushFillBuffers();
 
     void DoInitialise() override;
     void DoConfigure() override;
@@ -33,8 +45,42 @@ namespace eudaq {
     virtual void AtEventReception(eudaq::EventSP ev) = 0;
     virtual void AtReset() {}
 
+    /// Thread-safe filling of booked objects, buffered per thread and
+    /// applied in bulk under the window lock
+    void Fill(TH1* hist, double x, double w = 1.);
+    void Fill(TH2* hist, double x, double y, double w = 1.);
+    void Fill(TProfile* prof, double x, double y, double w = 1.);
+    void AddPoint(TGraph* graph, double x, double y);
+    void AddPoint(TGraph2D* graph, double x, double y, double z);
+
+  protected:
+    /// Call AtEventReception from num worker threads instead of the receiving
+    /// one; AtEventReception must then only fill through the methods above
+    void SetWorkerThreads(unsigned int num);
+    /// Drop the queued events and join the workers once they finished their
+    /// current one. A derived class using workers must call it in its
+    /// destructor: they call its AtEventReception, which the base class
+    /// destructor can not stop in time
+    void StopWorkers();
+
   private:
+    struct FillRecord {
+      enum Kind { kHist1D, kHist2D, kProfile, kGraph, kGraph2D };
+      TObject* object;
+      Kind kind;
+      double x, y, z, w;
+    };
+    struct FillBuffer {
+      std::mutex mtx;
+      std::vector<FillRecord> records;
+    };
     void LoadRAWFile(const std::string& path);
+    void Analyse(eudaq::EventSP ev);
+    void WorkerLoop();
+    void WaitWorkersIdle();
+    FillBuffer& ThreadBuffer();
+    void Push(const FillRecord& rec);
+    void ApplyFills(const std::vector<FillRecord>& recs);
 
     bool m_interrupt = false;
     std::unique_ptr<TApplication> m_app;
@@ -43,10 +89,25 @@ namespace eudaq {
     unsigned long long m_num_evt_mon = 0ull;
 
     // global monitoring plots
-    TH1D* m_glob_evt_reco_time, *m_glob_evt_num_subevt;
-    TGraph* m_glob_evt_vs_ts, *m_glob_rate_vs_ts;
+    TH1D* m_glob_evt_reco_time = nullptr, *m_glob_evt_num_subevt = nullptr;
+    TGraph* m_glob_evt_vs_ts = nullptr, *m_glob_rate_vs_ts = nullptr;
     unsigned long long m_glob_last_evt_ts = 0ull;
 
+    // per-thread fills, found by each thread through a thread-local cache
+    uint64_t m_instance;
+    std::mutex m_mtx_buffers;
+    std::vector<std::unique_ptr<FillBuffer> > m_buffers;
+
+    // events waiting for the workers
+    std::vector<std::thread> m_workers;
+    std::mutex m_mtx_que;
+    std::condition_variable m_cv_que;
+    std::condition_variable m_cv_idle;
+    std::deque<eudaq::EventSP> m_que;
+    size_t m_que_max = 0;
+    unsigned int m_busy = 0;
+    bool m_stop_workers = false;
+
   protected:
     std::unique_ptr<ROOTMonitorWindow> m_monitor;
   };
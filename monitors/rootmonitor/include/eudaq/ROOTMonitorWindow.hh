@@ -14,6 +14,8 @@
 # include "RQ_OBJECT.h"
 #endif
 #include <functional>
+#include <mutex>
+#include <atomic>
 
 class TApplication;
 class TTree;
@@ -54,20 +56,18 @@ namespace eudaq{
     void ClearMonitors();
 
     /// Add a new monitor to the stack, as a simple TObject-derivative
+    /// May be called from any thread, the entry in the list tree is added at the next Update
     template<typename T, typename... Args> T* Book(const std::string& path, const std::string& name, Args&&... args) {
-      if (m_objects.count(path) != 0)
-        return Get<T>(path);
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      auto it = m_objects.find(path);
+      if (it != m_objects.end())
+        return dynamic_cast<T*>(it->second.object);
       auto obj = new T(std::forward<Args>(args)...);
-      auto item = m_tree_list->AddItem(BookStructure(path), name.c_str());
-      auto it_icon = m_obj_icon.find(obj->ClassName());
-      if (it_icon != m_obj_icon.end())
-        item->SetPictures(it_icon->second, it_icon->second);
       MonitoredObject mon;
-      mon.item = item;
+      mon.name = name;
       mon.object = obj;
       m_objects[path] = mon;
-      m_left_canv->MapSubwindows();
-      m_left_canv->MapWindow();
+      m_pending.emplace_back(path);
       return obj;
     }
     /// Retrieve a monitored object by its path and type
@@ -77,16 +77,31 @@ namespace eudaq{
     /// Retrieve a monitored object by its path
     TObject* Get(const std::string& name);
     /// Specify if an object is required to be cleaned at each refresh
-    void SetPersistant(const TObject* obj, bool pers = true) { GetMonitor(obj).persist = pers; }
+    void SetPersistant(const TObject* obj, bool pers = true) {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      GetMonitor(obj).persist = pers;
+    }
     /// Specify the drawing properties of the object in the monitor
-    void SetDrawOptions(const TObject* obj, Option_t* opt) { GetMonitor(obj).draw_opt = opt; }
+    void SetDrawOptions(const TObject* obj, Option_t* opt) {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      GetMonitor(obj).draw_opt = opt;
+    }
     /// Specify the y axis range for a monitored object
     void SetRangeY(const TObject* obj, double min, double max) {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
       auto& mon = GetMonitor(obj);
       mon.min_y = min, mon.max_y = max;
     }
     /// Specify if the x-axis should be associated with time
-    void SetTimeSeries(const TObject* obj, const std::string& time) { GetMonitor(obj).time_series = time; }
+    void SetTimeSeries(const TObject* obj, const std::string& time) {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      GetMonitor(obj).time_series = time;
+    }
+    /// Lock held while the monitored objects are drawn, cleaned or saved;
+    /// objects filled from another thread than the GUI one must be filled under it
+    std::recursive_mutex& GetMutex() { return m_mutex; }
+    /// Tell the window that monitored objects have changed since the last refresh
+    void SetModified() { m_modified = true; }
 
     /// Action triggered when a monitor is to be drawn
     void DrawElement(TGListTreeItem*, int);
@@ -103,11 +118,15 @@ namespace eudaq{
     void Quit();
     /// Reprocess monitors from a RAW file
     void FillFromRAWFile(const char* path);
+    /// Emitted before each refresh, to move pending fills into the monitored objects
+    void FlushFills();
 
   private:
     /// List of status bar attributes
     enum class StatusBarPos { status = 0, run_number, tot_events, an_events, num_parts };
     TGListTreeItem* BookStructure(const std::string& path, TGListTreeItem* par = nullptr);
+    /// Add the list tree entries of objects booked since the last refresh
+    void MapPending();
     void CleanObject(TObject*);
     void FillFileObject(const std::string& path, TObject* obj, const std::string& path_par = "");
     void Draw(TCanvas* canv);
@@ -133,6 +152,7 @@ namespace eudaq{
     std::unique_ptr<TTimer> m_timer;
     static constexpr double kInvalidValue = 42.424242;
     struct MonitoredObject {
+      std::string name;
       TGListTreeItem* item = nullptr;
       TObject* object = nullptr;
       bool persist = true;
@@ -145,6 +165,11 @@ namespace eudaq{
 
     /// List of all objects handled and monitored
     std::map<std::string, MonitoredObject> m_objects;
+    /// Objects and summaries booked, but not yet shown in the list tree
+    std::vector<std::string> m_pending;
+    std::vector<std::pair<std::string, const TObject*> > m_pending_summ;
+    std::recursive_mutex m_mutex;
+    std::atomic<bool> m_modified{true};
     std::map<std::string, TGListTreeItem*> m_dirs;
     /// List of all summary plots sharing one canvas
     std::map<std::string, std::vector<std::string> > m_summaries;
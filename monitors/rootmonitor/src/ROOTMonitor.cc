@@ -4,16 +4,26 @@
 #include "eudaq/DataConverter.hh"
 
 #include "TH1.h"
+#include "TH2.h"
+#include "TProfile.h"
 #include "TGraph.h"
+#include "TGraph2D.h"
 
 #include <ratio>
 #include <chrono>
 #include <thread>
+#include <map>
+#include <atomic>
 
 namespace eudaq {
+  namespace {
+    std::atomic<uint64_t> g_instance_c(0);
+  }
+
   ROOTMonitor::ROOTMonitor(const std::string & name, const std::string & title, const std::string & runcontrol)
     :Monitor(name, runcontrol),
      m_app(new TApplication(name.c_str(), nullptr, nullptr)),
+     m_instance(g_instance_c++),
      m_monitor(new ROOTMonitorWindow(m_app.get(), title)){
     if (!m_monitor)
       EUDAQ_THROW("Error allocating main window");
@@ -21,6 +31,7 @@ namespace eudaq {
     m_monitor->SetStatus(eudaq::Status::STATE_UNINIT);
     m_monitor->Connect("FillFromRAWFile(const char*)", NAME, this, "LoadRAWFileAsync(const char*)");
     m_monitor->Connect("Quit()", NAME, this, "DoTerminate()");
+    m_monitor->Connect("FlushFills()", NAME, this, "FlushFillBuffers()");
 
     // launch the run loop
     m_app->SetReturnFromRun(true);
@@ -28,6 +39,11 @@ namespace eudaq {
       m_daemon = std::async(std::launch::async, &TApplication::Run, m_app.get(), 0);
   }
 
+  ROOTMonitor::~ROOTMonitor(){
+    // only a fallback, the derived class is gone already (see StopWorkers)
+    StopWorkers();
+  }
+
   void ROOTMonitor::DoInitialise(){
     m_monitor->ResetCounters();
     m_monitor->SetStatus(eudaq::Status::STATE_STOPPED);
@@ -50,6 +66,9 @@ namespace eudaq {
   }
 
   void ROOTMonitor::DoStartRun(){
+    // leftovers of the previous run go before the monitors are cleared
+    WaitWorkersIdle();
+    FlushFillBuffers();
     m_monitor->ResetCounters();
     m_monitor->SetStatus(eudaq::Status::STATE_RUNNING);
     m_monitor->SetRunNumber(GetRunNumber());
@@ -57,25 +76,201 @@ namespace eudaq {
   }
 
   void ROOTMonitor::DoReceive(eudaq::EventSP ev){
-    auto start = std::chrono::system_clock::now();
     // update the counters
     m_monitor->SetCounters(ev->GetEventN(), ++m_num_evt_mon);
-    // user-specific filling part
-    AtEventReception(ev);
-    // global event information
-    std::chrono::duration<double> elapsed_sec = std::chrono::system_clock::now()-start;
-    m_glob_evt_reco_time->Fill(elapsed_sec.count()*1.e3);
-    m_glob_evt_num_subevt->Fill(ev->GetNumSubEvent());
+    // global event information, in the order of reception
+    Fill(m_glob_evt_num_subevt, ev->GetNumSubEvent());
     if (ev->GetTimestampBegin() != 0) {
-      m_glob_evt_vs_ts->SetPoint(m_glob_evt_vs_ts->GetN(), ev->GetTimestampBegin(), ev->GetEventID());
+      AddPoint(m_glob_evt_vs_ts, ev->GetTimestampBegin(), ev->GetEventID());
       const double rate = (ev->GetTimestampBegin() != m_glob_last_evt_ts)
         ? 1./(ev->GetTimestampBegin()-m_glob_last_evt_ts) : 0.;
-      m_glob_rate_vs_ts->SetPoint(m_glob_rate_vs_ts->GetN(), ev->GetTimestampBegin(), rate);
+      AddPoint(m_glob_rate_vs_ts, ev->GetTimestampBegin(), rate);
       m_glob_last_evt_ts = ev->GetTimestampBegin();
     }
+    if (m_workers.empty()) {
+      Analyse(ev);
+      return;
+    }
+    // hand the event to the workers, wait if they are behind
+    std::unique_lock<std::mutex> lk(m_mtx_que);
+    m_cv_idle.wait(lk, [this]{ return m_stop_workers || m_que.size() < m_que_max; });
+    if (m_stop_workers)
+      return;
+    m_que.push_back(ev);
+    lk.unlock();
+    m_cv_que.notify_one();
+  }
+
+  void ROOTMonitor::Analyse(eudaq::EventSP ev){
+    auto start = std::chrono::system_clock::now();
+    // user-specific filling part
+    if (m_workers.empty()) {
+      // the receiving thread may fill directly, but not while the GUI draws
+      std::lock_guard<std::recursive_mutex> lock(m_monitor->GetMutex());
+      AtEventReception(ev);
+    }
+    else
+      AtEventReception(ev);
+    std::chrono::duration<double> elapsed_sec = std::chrono::system_clock::now()-start;
+    Fill(m_glob_evt_reco_time, elapsed_sec.count()*1.e3);
+    m_monitor->SetModified();
+  }
+
+  void ROOTMonitor::SetWorkerThreads(unsigned int num){
+    // StopWorkers drops what is queued
+    WaitWorkersIdle();
+    StopWorkers();
+    {
+      std::lock_guard<std::mutex> lk(m_mtx_que);
+      m_stop_workers = false;
+      m_que_max = 4*num;
+    }
+    for (unsigned int i = 0; i < num; ++i)
+      m_workers.emplace_back(&ROOTMonitor::WorkerLoop, this);
+  }
+
+  void ROOTMonitor::WorkerLoop(){
+    while (true) {
+      std::unique_lock<std::mutex> lk(m_mtx_que);
+      m_cv_que.wait(lk, [this]{ return m_stop_workers || !m_que.empty(); });
+      if (m_stop_workers)
+        return;
+      auto ev = m_que.front();
+      m_que.pop_front();
+      m_busy++;
+      lk.unlock();
+      m_cv_idle.notify_all();
+      try {
+        Analyse(ev);
+      }
+      catch (const std::exception& e) {
+        EUDAQ_WARN(GetName()+" failed to analyse event "+std::to_string(ev->GetEventN())+": "+e.what());
+      }
+      lk.lock();
+      m_busy--;
+      lk.unlock();
+      m_cv_idle.notify_all();
+    }
+  }
+
+  void ROOTMonitor::WaitWorkersIdle(){
+    std::unique_lock<std::mutex> lk(m_mtx_que);
+    m_cv_idle.wait(lk, [this]{ return m_que.empty() && m_busy == 0; });
+  }
+
+  void ROOTMonitor::StopWorkers(){
+    std::unique_lock<std::mutex> lk(m_mtx_que);
+    m_stop_workers = true;
+    // not analysed any more, AtEventReception may belong to a destroyed object
+    m_que.clear();
+    lk.unlock();
+    m_cv_que.notify_all();
+    m_cv_idle.notify_all();
+    for (auto& th : m_workers)
+      th.join();
+    m_workers.clear();
+  }
+
+  //--- thread-safe filling
+
+  void ROOTMonitor::Fill(TH1* hist, double x, double w){
+    Push({hist, FillRecord::kHist1D, x, 0., 0., w});
+  }
+
+  void ROOTMonitor::Fill(TH2* hist, double x, double y, double w){
+    Push({hist, FillRecord::kHist2D, x, y, 0., w});
+  }
+
+  void ROOTMonitor::Fill(TProfile* prof, double x, double y, double w){
+    Push({prof, FillRecord::kProfile, x, y, 0., w});
+  }
+
+  void ROOTMonitor::AddPoint(TGraph* graph, double x, double y){
+    Push({graph, FillRecord::kGraph, x, y, 0., 1.});
+  }
+
+  void ROOTMonitor::AddPoint(TGraph2D* graph, double x, double y, double z){
+    Push({graph, FillRecord::kGraph2D, x, y, z, 1.});
+  }
+
+  ROOTMonitor::FillBuffer& ROOTMonitor::ThreadBuffer(){
+    thread_local std::map<uint64_t, FillBuffer*> cache;
+    auto it = cache.find(m_instance);
+    if (it != cache.end())
+      return *it->second;
+    std::lock_guard<std::mutex> lk(m_mtx_buffers);
+    m_buffers.emplace_back(new FillBuffer);
+    cache[m_instance] = m_buffers.back().get();
+    return *m_buffers.back();
+  }
+
+  void ROOTMonitor::Push(const FillRecord& rec){
+    if (!rec.object)
+      return;
+    auto& buf = ThreadBuffer();
+    std::unique_lock<std::mutex> lk(buf.mtx);
+    buf.records.push_back(rec);
+    if (buf.records.size() < 4096)
+      return;
+    std::vector<FillRecord> recs;
+    recs.swap(buf.records);
+    lk.unlock();
+    std::lock_guard<std::recursive_mutex> lock(m_monitor->GetMutex());
+    ApplyFills(recs);
+  }
+
+  void ROOTMonitor::FlushFillBuffers(){
+    // buffers are never removed, but the list must not be locked together
+    // with the window: a thread filling under the window lock may be adding
+    // its buffer right now
+    std::vector<FillBuffer*> bufs;
+    std::unique_lock<std::mutex> lk_buf(m_mtx_buffers);
+    for (auto& buf : m_buffers)
+      bufs.push_back(buf.get());
+    lk_buf.unlock();
+    std::vector<FillRecord> recs;
+    for (auto buf : bufs) {
+      std::unique_lock<std::mutex> lk(buf->mtx);
+      recs.swap(buf->records);
+      lk.unlock();
+      if (recs.empty())
+        continue;
+      std::lock_guard<std::recursive_mutex> lock(m_monitor->GetMutex());
+      ApplyFills(recs);
+      recs.clear();
+    }
+  }
+
+  void ROOTMonitor::ApplyFills(const std::vector<FillRecord>& recs){
+    for (const auto& rec : recs) {
+      switch (rec.kind) {
+      case FillRecord::kHist1D:
+        static_cast<TH1*>(rec.object)->Fill(rec.x, rec.w);
+        break;
+      case FillRecord::kHist2D:
+        static_cast<TH2*>(rec.object)->Fill(rec.x, rec.y, rec.w);
+        break;
+      case FillRecord::kProfile:
+        static_cast<TProfile*>(rec.object)->Fill(rec.x, rec.y, rec.w);
+        break;
+      case FillRecord::kGraph: {
+        auto graph = static_cast<TGraph*>(rec.object);
+        graph->SetPoint(graph->GetN(), rec.x, rec.y);
+        break;
+      }
+      case FillRecord::kGraph2D: {
+        auto graph = static_cast<TGraph2D*>(rec.object);
+        graph->SetPoint(graph->GetN(), rec.x, rec.y, rec.z);
+        break;
+      }
+      }
+    }
+    m_monitor->SetModified();
   }
 
   void ROOTMonitor::DoStopRun(){
+    WaitWorkersIdle();
+    FlushFillBuffers();
     m_monitor->SetStatus(eudaq::Status::STATE_STOPPED);
     AtRunStop();
   }
@@ -90,6 +285,7 @@ namespace eudaq {
     m_interrupt = true;
     if (!m_daemon_load.empty())
       m_daemon_load.clear();
+    StopWorkers();
     m_app->Terminate(1);
   }
 
@@ -127,7 +323,8 @@ namespace eudaq {
       num_evts++;
     } while (reader.HasData());
     EUDAQ_INFO(GetName()+" processed "+std::to_string(num_evts)+" events");
-    m_monitor->Update();
+    // DoStopRun waits for the workers and flushes the fills before the final refresh
     DoStopRun();
+    m_monitor->Update();
   }
 }
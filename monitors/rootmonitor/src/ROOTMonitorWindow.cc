@@ -17,6 +17,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 namespace eudaq {
   ROOTMonitorWindow::ROOTMonitorWindow(TApplication* par, const std::string& name)
@@ -133,6 +134,10 @@ namespace eudaq {
     Emit("FillFromRAWFile(const char*)", path);
   }
 
+  void ROOTMonitorWindow::FlushFills(){
+    Emit("FlushFills()");
+  }
+
   //--- counters/status bookeeping
 
   void ROOTMonitorWindow::SetCounters(unsigned long long evt_recv, unsigned long long evt_mon){
@@ -247,6 +252,7 @@ namespace eudaq {
 
   void ROOTMonitorWindow::SaveFile(const char* filename){
     // save all collections
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     auto file = std::unique_ptr<TFile>(TFile::Open(filename, "recreate"));
     for (auto& obj : m_objects) {
       TString s_file(obj.first);
@@ -283,17 +289,22 @@ namespace eudaq {
   //--- graphical part
 
   void ROOTMonitorWindow::Update(){
+    MapPending();
     SetLastEventNum(m_last_event);
     SetMonitoredEventsNum(m_last_event_mon);
+    FlushFills();
 
-    // check if we have something to draw
-    if (m_drawable.empty())
+    // check if we have something to draw, and somebody to look at it
+    if (m_drawable.empty() || !IsMapped() || !m_main_canvas->IsMapped())
+      return;
+    if (!m_modified.exchange(false) && !m_canv_needs_refresh)
       return;
     TCanvas* canv = m_main_canvas->GetCanvas();
     if (!canv) { // failed to retrieve the plotting region
       std::cerr << "[WARNING] Failed to retrieve the main plotting canvas!" << std::endl;
       return;
     }
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     Draw(canv);
     PostDraw(canv);
   }
@@ -362,6 +373,7 @@ namespace eudaq {
   //--- monitoring elements helpers
 
   TObject* ROOTMonitorWindow::Get(const std::string& name){
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     auto it = m_objects.find(name);
     if (it == m_objects.end())
       throw std::runtime_error("Failed to retrieve object with path \""+std::string(name)+"\"!");
@@ -369,13 +381,14 @@ namespace eudaq {
   }
 
   void ROOTMonitorWindow::DrawElement(TGListTreeItem* it, int val){
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     m_drawable.clear();
     for (auto& obj : m_objects)
       if (obj.second.item == it)
         m_drawable.emplace_back(&obj.second);
     if (m_drawable.empty()) // did not find in objects, must be a directory
       for (auto& obj : m_objects)
-        if (obj.second.item->GetParent() == it)
+        if (obj.second.item && obj.second.item->GetParent() == it)
           m_drawable.emplace_back(&obj.second);
     if (m_drawable.empty()) // did not find in directories either, must be a summary
       if (m_summ_objects.count(it) > 0)
@@ -398,8 +411,10 @@ namespace eudaq {
 
   void ROOTMonitorWindow::ClearMonitors(){
     // clear non-persistent objects before next refresh
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     for (auto& dr : m_objects)
       CleanObject(dr.second.object);
+    m_modified = true;
   }
 
   void ROOTMonitorWindow::CleanObject(TObject* obj){
@@ -440,9 +455,30 @@ namespace eudaq {
   }
 
   void ROOTMonitorWindow::AddSummary(const std::string& path, const TObject* obj){
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     for (auto& o : m_objects) {
       if (o.second.object != obj)
         continue;
+      m_pending_summ.emplace_back(path, obj);
+      return;
+    }
+    throw std::runtime_error("Failed to retrieve an object for summary \""+path+"\"");
+  }
+
+  void ROOTMonitorWindow::MapPending(){
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (m_pending.empty() && m_pending_summ.empty())
+      return;
+    for (const auto& path : m_pending) {
+      auto& mon = m_objects[path];
+      mon.item = m_tree_list->AddItem(BookStructure(path), mon.name.c_str());
+      auto it_icon = m_obj_icon.find(mon.object->ClassName());
+      if (it_icon != m_obj_icon.end())
+        mon.item->SetPictures(it_icon->second, it_icon->second);
+    }
+    m_pending.clear();
+    for (const auto& summ : m_pending_summ) {
+      const auto& path = summ.first;
       if (m_dirs.count(path) == 0) {
         auto obj_name = path;
         // keep only the last part
@@ -451,12 +487,13 @@ namespace eudaq {
         m_dirs[path]->SetPictures(m_icon_summ, m_icon_summ);
       }
       auto& objs = m_summ_objects[m_dirs[path]];
-      if (std::find(objs.begin(), objs.end(), &o.second) == objs.end())
-        objs.emplace_back(&o.second);
-      m_left_canv->MapSubwindows();
-      m_left_canv->MapWindow();
-      return;
+      for (auto& o : m_objects)
+        if (o.second.object == summ.second
+            && std::find(objs.begin(), objs.end(), &o.second) == objs.end())
+          objs.emplace_back(&o.second);
     }
-    throw std::runtime_error("Failed to retrieve an object for summary \""+path+"\"");
+    m_pending_summ.clear();
+    m_left_canv->MapSubwindows();
+    m_left_canv->MapWindow();
   }
 }
@@ -204,6 +204,8 @@ bool CLICTDEvent2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::Standa
   eudaq::StandardPlane plane(0, "Caribou", "CLICTD");
 
   plane.SetSizeZS(128, 128, 0);
+  // up to 8 hits per readout
+  plane.Reserve(0, data.size() * 8);
   for(const auto& px : data) {
     auto pixel = dynamic_cast<caribou::CLICTDPixelReadout*>(px.second.get());
 
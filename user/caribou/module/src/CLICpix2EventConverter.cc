@@ -159,6 +159,7 @@ bool CLICpix2Event2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::Stan
   eudaq::StandardPlane plane(0, "Caribou", "CLICpix2");
 
   plane.SetSizeZS(128, 128, 0);
+  plane.Reserve(0, data.size());
   for(const auto& px : data) {
     auto cp2_pixel = dynamic_cast<caribou::pixelReadout*>(px.second.get());
     int col = px.first.first;
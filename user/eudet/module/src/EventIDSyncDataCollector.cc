@@ -16,7 +16,7 @@ namespace eudaq {
       static const uint32_t m_id_factory = eudaq::cstr2hash("EventIDSyncDataCollector");
 
     private:
-      std::map<std::string, std::deque<EventSPC>> m_que_event;
+      std::map<std::string, EventSpillQueueSP> m_que_event;
       std::mutex m_mtx_map;
   };
 
@@ -29,7 +29,7 @@ namespace eudaq {
   void EventIDSyncDataCollector::DoStartRun(){
     std::unique_lock<std::mutex> lk(m_mtx_map);
     for(auto &que :m_que_event){
-      que.second.clear();
+      que.second->Clear();
     }
   }
 
@@ -39,7 +39,7 @@ namespace eudaq {
     EUDAQ_INFO("Producer."+pdc_name+" is connecting");
     if(m_que_event.find(pdc_name) != m_que_event.end())
       EUDAQ_THROW("DataCollector::Doconnect, multiple producers are sharing a same name");
-    m_que_event[pdc_name];
+    m_que_event[pdc_name] = CreateEventQueue(pdc_name);
   }
 
   void EventIDSyncDataCollector::DoDisconnect(ConnectionSPC id){
@@ -47,29 +47,47 @@ namespace eudaq {
     std::string pdc_name = id->GetName();
     if(m_que_event.find(pdc_name) == m_que_event.end())
       EUDAQ_THROW("DataCollector::DisDoconnect, the disconnecting producer was not existing in list");
-    EUDAQ_WARN("Producer."+pdc_name+" is disconnected, the remaining events are erased. ("+std::to_string(m_que_event[pdc_name].size())+ " Events)");
+    EUDAQ_WARN("Producer."+pdc_name+" is disconnected, the remaining events are erased. ("+std::to_string(m_que_event[pdc_name]->Size())+ " Events)");
+    RemoveEventQueue(m_que_event[pdc_name]);
     m_que_event.erase(pdc_name);
   }
 
   void EventIDSyncDataCollector::DoReceive(ConnectionSPC id, EventSP ev){
     std::unique_lock<std::mutex> lk(m_mtx_map);
     std::string pdc_name = id->GetName();
-    m_que_event[pdc_name].push_back(std::move(ev));
-    uint32_t n = 0;
-    for(auto &que :m_que_event){
-      if(!que.second.empty())
-        n++;
-    }
-    if(n==m_que_event.size()){
+    auto &que_pdc = m_que_event[pdc_name];
+    if(!que_pdc)
+      que_pdc = CreateEventQueue(pdc_name);
+    que_pdc->Push(std::move(ev));
+    BalanceEventQueues();
+    // once a stalled stream has timed out, the others may hold a backlog
+    // (possibly spilled to disk), so build every event that is complete
+    for(;;){
+      uint32_t n = 0;
+      // event numbers are compared to the stream that just sent one
+      EventSPC ev_front = que_pdc->Empty() ? nullptr : que_pdc->Front();
+      for(auto &que :m_que_event){
+        if(!que.second->Empty()){
+          if(!ev_front)
+            ev_front = que.second->Front();
+          n++;
+        }
+        else if(IsEventQueueTimedOut(que.second))
+          n++;
+      }
+      if(!ev_front || n != m_que_event.size())
+        break;
       auto ev_wrap = Event::MakeUnique("EventIDSyncOnline");
       ev_wrap->SetFlagPacket();
-      uint32_t ev_c = m_que_event.begin()->second.front()->GetEventN();
+      uint32_t ev_c = ev_front->GetEventN();
       bool match = true;
       for(auto &que :m_que_event){
-        if(ev_c != que.second.front()->GetEventN())
+        if(que.second->Empty())
+          continue;
+        if(ev_c != que.second->Front()->GetEventN())
           match = false;
-        ev_wrap->AddSubEvent(que.second.front());
-        que.second.pop_front();
+        ev_wrap->AddSubEvent(que.second->Front());
+        que.second->Pop();
       }
       if(!match){
         EUDAQ_WARN("EventNumbers are Mismatched");
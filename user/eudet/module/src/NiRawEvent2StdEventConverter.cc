@@ -8,9 +8,14 @@
 class NiRawEvent2StdEventConverter: public eudaq::StdEventConverter{
   typedef std::vector<uint8_t>::const_iterator datait;
 public:
+  // hits of one frame, reused for all frames of an event
+  struct FrameHits {
+    std::vector<uint16_t> xs, ys;
+    std::vector<uint8_t> pivots;
+  };
   bool Converting(eudaq::EventSPC d1, eudaq::StandardEventSP d2, eudaq::ConfigurationSPC conf) const override;
   void DecodeFrame(eudaq::StandardPlane& plane, const uint32_t fm_n,
-		   const uint8_t *const d, const size_t l32) const;
+		   const uint8_t *const d, const size_t l32, FrameHits &hits) const;
   static const uint32_t m_id_factory = eudaq::cstr2hash("NiRawDataEvent");
 };
   
@@ -39,15 +44,18 @@ bool NiRawEvent2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::Standar
     d2->SetTimestamp(d1->GetTimestampBegin(), d1->GetTimestampEnd(), d1->IsFlagTimestamp());
   }
     
+  const bool compact = conf && conf->Get("COMPACT_HITS", 0);
   auto &rawev = *ev;
-  if (rawev.NumBlocks() < 2 || rawev.GetBlock(0).size() < 20 ||
-      rawev.GetBlock(1).size() < 20) {
+  if (rawev.NumBlocks() < 2 || rawev.GetBlockRef(0).size() < 20 ||
+      rawev.GetBlockRef(1).size() < 20) {
     EUDAQ_WARN("Ignoring bad event " + std::to_string(rawev.GetEventNumber()));
     return false;
   }
 
-  const std::vector<uint8_t> &data0 = rawev.GetBlock(0);
-  const std::vector<uint8_t> &data1 = rawev.GetBlock(1);
+  // decoded from the event's own bytes, GetBlock would copy them
+  const std::vector<uint8_t> &data0 = rawev.GetBlockRef(0);
+  const std::vector<uint8_t> &data1 = rawev.GetBlockRef(1);
+  FrameHits hits;
   uint32_t header0 = eudaq::getlittleendian<uint32_t>(&data0[0]);
   uint32_t header1 = eudaq::getlittleendian<uint32_t>(&data1[0]);
   uint16_t pivot = eudaq::getlittleendian<uint16_t>(&data0[4]);
@@ -93,9 +101,12 @@ bool NiRawEvent2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::Standar
     eudaq::StandardPlane plane(id, "NI", "MIMOSA26");
     plane.SetSizeZS(1152, 576, 0, 2, eudaq::StandardPlane::FLAG_WITHPIVOT |
 		    eudaq::StandardPlane::FLAG_DIFFCOORDS);
+    // the compact layout is not readable by older EUDAQ, only on request
+    if(compact)
+      plane.SetCompact(0);
     plane.SetPivotPixel((9216 + pivot + PIVOTPIXELOFFSET) % 9216);
-    DecodeFrame(plane, 0, &it0[8], len0);
-    DecodeFrame(plane, 1, &it1[8], len1);
+    DecodeFrame(plane, 0, &it0[8], len0, hits);
+    DecodeFrame(plane, 1, &it1[8], len1, hits);
     d2->AddPlane(plane);
 
     bool advance_one_block_0 = false;
@@ -128,29 +139,38 @@ bool NiRawEvent2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::Standar
 }
 
 void NiRawEvent2StdEventConverter::DecodeFrame(eudaq::StandardPlane& plane, const uint32_t fm_n,
-					       const uint8_t *const d, const size_t l32) const{
-  std::vector<uint16_t> vec;
-  for (size_t i = 0; i < l32; ++i) {
-    vec.push_back(eudaq::getlittleendian<uint16_t>(d+i*4));
-    vec.push_back(eudaq::getlittleendian<uint16_t>(d+i*4+2));
-  }
-
-  size_t lvec = vec.size();
+					       const uint8_t *const d, const size_t l32,
+					       FrameHits &hits) const{
+  // The frame is a stream of 16-bit words: a row header (row << 4 | numstates)
+  // followed by numstates column words (column << 2 | npixel-1).
+  // Every word yields at most 4 hits, which bounds the buffers below.
+  const size_t lvec = l32 * 2;
+  const uint16_t pivot_row = plane.PivotPixel() / 16;
+  hits.xs.clear();
+  hits.ys.clear();
+  hits.pivots.clear();
+  hits.xs.reserve(lvec * 4);
+  hits.ys.reserve(lvec * 4);
+  hits.pivots.reserve(lvec * 4);
   for (size_t i = 0; i+1 < lvec; ++i) {
-    uint16_t numstates = vec[i] & 0x000f;
-    uint16_t row = vec[i] >> 4 & 0x7ff;
+    uint16_t w = eudaq::getlittleendian<uint16_t>(d+i*2);
+    uint16_t numstates = w & 0x000f;
+    uint16_t row = w >> 4 & 0x7ff;
     if (i+1+numstates > lvec){ //offset+ [row] + [column......]
       break;
     }
-    bool pivot = (row >= (plane.PivotPixel() / 16));
+    uint8_t pivot = (row >= pivot_row);
     for (uint16_t s = 0; s < numstates; ++s) {
-      uint16_t v = vec.at(++i);
+      uint16_t v = eudaq::getlittleendian<uint16_t>(d+(++i)*2);
       uint16_t column = v >> 2 & 0x7ff;
       uint16_t num = v & 3;
       for (uint16_t j = 0; j < num + 1; ++j) {
-        plane.PushPixel(column + j, row, 1,0, pivot, fm_n);
+	hits.xs.push_back(column + j);
+	hits.ys.push_back(row);
+	hits.pivots.push_back(pivot);
       }
     }
   }
-      
+  plane.AppendHits(fm_n, hits.xs, hits.ys, std::vector<uint16_t>(),
+		   std::vector<uint64_t>(), hits.pivots);
 }
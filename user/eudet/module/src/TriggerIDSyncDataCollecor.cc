@@ -19,7 +19,7 @@ namespace eudaq {
 
     private:
       std::mutex m_mtx_map;
-      std::map<ConnectionSPC, std::deque<EventSPC>> m_conn_evque;
+      std::map<ConnectionSPC, EventSpillQueueSP> m_conn_evque;
       std::set<ConnectionSPC> m_conn_inactive;
       uint32_t m_noprint;
   };
@@ -37,7 +37,11 @@ namespace eudaq {
 
   void TriggerIDSyncDataCollector::DoConnect(ConnectionSPC idx){
     std::unique_lock<std::mutex> lk(m_mtx_map);
-    m_conn_evque[idx].clear();
+    auto &que = m_conn_evque[idx];
+    if(que)
+      que->Clear();
+    else
+      que = CreateEventQueue(idx->GetName());
     m_conn_inactive.erase(idx);
   }
 
@@ -46,6 +50,8 @@ namespace eudaq {
     m_conn_inactive.insert(idx);
     if(m_conn_inactive.size() == m_conn_evque.size()){
       m_conn_inactive.clear();
+      for(auto &conn_evque: m_conn_evque)
+        RemoveEventQueue(conn_evque.second);
       m_conn_evque.clear();
     }
   }
@@ -62,6 +68,8 @@ namespace eudaq {
   void TriggerIDSyncDataCollector::DoReset(){
     std::unique_lock<std::mutex> lk(m_mtx_map);
     m_noprint = 0;
+    for(auto &conn_evque: m_conn_evque)
+      RemoveEventQueue(conn_evque.second);
     m_conn_evque.clear();
     m_conn_inactive.clear();
   }
@@ -71,45 +79,62 @@ namespace eudaq {
     if(!evsp->IsFlagTrigger()){
       EUDAQ_THROW("!evsp->IsFlagTrigger()");
     }
-    m_conn_evque[idx].push_back(evsp);
+    auto &que = m_conn_evque[idx];
+    if(!que)
+      que = CreateEventQueue(idx->GetName());
+    que->Push(evsp);
+    BalanceEventQueues();
 
-    uint32_t trigger_n = -1;
-    for(auto &conn_evque: m_conn_evque){
-      if(conn_evque.second.empty())
-        return;
-      else{
-        uint32_t trigger_n_ev = conn_evque.second.front()->GetTriggerN();
-        if(trigger_n_ev< trigger_n)
-          trigger_n = trigger_n_ev;
+    // once a stalled stream has timed out, the others may hold a backlog
+    // (possibly spilled to disk), so build every event that is complete
+    for(;;){
+      uint32_t trigger_n = -1;
+      bool data = false;
+      for(auto &conn_evque: m_conn_evque){
+	if(conn_evque.second->Empty()){
+	  if(IsEventQueueTimedOut(conn_evque.second))
+	    continue;
+	  return;
+	}
+	else{
+	  data = true;
+	  uint32_t trigger_n_ev = conn_evque.second->Front()->GetTriggerN();
+	  if(trigger_n_ev< trigger_n)
+	    trigger_n = trigger_n_ev;
+	}
       }
-    }
 
-    auto ev_sync = Event::MakeUnique("TriggerIDSyncOnline");
-    ev_sync->SetFlagPacket();
-    ev_sync->SetTriggerN(trigger_n);
-    for(auto &conn_evque: m_conn_evque){
-      auto &ev_front = conn_evque.second.front(); 
-      if(ev_front->GetTriggerN() == trigger_n){
-        ev_sync->AddSubEvent(ev_front);
-        conn_evque.second.pop_front();
-      }
-    }
+      if(!data)
+	return;
 
-    if(!m_conn_inactive.empty()){
-      std::set<ConnectionSPC> conn_inactive_empty;
-      for(auto &conn: m_conn_inactive){
-        if(m_conn_evque.find(conn) != m_conn_evque.end() && 
-            m_conn_evque[conn].empty()){
-          m_conn_evque.erase(conn);
-          conn_inactive_empty.insert(conn);	
-        }
+      auto ev_sync = Event::MakeUnique("TriggerIDSyncOnline");
+      ev_sync->SetFlagPacket();
+      ev_sync->SetTriggerN(trigger_n);
+      for(auto &conn_evque: m_conn_evque){
+	auto &que = conn_evque.second;
+	if(!que->Empty() && que->Front()->GetTriggerN() == trigger_n){
+	  ev_sync->AddSubEvent(que->Front());
+	  que->Pop();
+	}
       }
-      for(auto &conn: conn_inactive_empty){
-        m_conn_inactive.erase(conn);
+
+      if(!m_conn_inactive.empty()){
+	std::set<ConnectionSPC> conn_inactive_empty;
+	for(auto &conn: m_conn_inactive){
+	  if(m_conn_evque.find(conn) != m_conn_evque.end() && 
+	      m_conn_evque[conn]->Empty()){
+	    RemoveEventQueue(m_conn_evque[conn]);
+	    m_conn_evque.erase(conn);
+	    conn_inactive_empty.insert(conn);	
+	  }
+	}
+	for(auto &conn: conn_inactive_empty){
+	  m_conn_inactive.erase(conn);
+	}
       }
+      if(!m_noprint)
+	ev_sync->Print(std::cout);
+      WriteEvent(std::move(ev_sync));
     }
-    if(!m_noprint)
-      ev_sync->Print(std::cout);
-    WriteEvent(std::move(ev_sync));
   }
 }
@@ -4,6 +4,8 @@
 #include "TGraph2D.h"
 #include "TProfile.h"
 
+#include <thread>
+
 // let there be a user-defined Ex0EventDataFormat, containing e.g. three
 // double-precision attributes get'ters:
 //   double GetQuantityX(), double GetQuantityY(), and double GetQuantityZ()
@@ -17,7 +19,14 @@ struct Ex0EventDataFormat {
 class Ex0ROOTMonitor : public eudaq::ROOTMonitor {
 public:
   Ex0ROOTMonitor(const std::string& name, const std::string& runcontrol):
-    eudaq::ROOTMonitor(name, "Ex0 ROOT monitor", runcontrol){}
+    eudaq::ROOTMonitor(name, "Ex0 ROOT monitor", runcontrol){
+    // events are analysed in parallel, hence the thread-safe Fill/AddPoint below
+    SetWorkerThreads(std::thread::hardware_concurrency());
+  }
+  ~Ex0ROOTMonitor() override {
+    // the workers call AtEventReception, stop them while this still exists
+    StopWorkers();
+  }
 
   void AtConfiguration() override;
   void AtEventReception(eudaq::EventSP ev) override;
@@ -47,9 +56,9 @@ void Ex0ROOTMonitor::AtConfiguration(){
 
 void Ex0ROOTMonitor::AtEventReception(eudaq::EventSP ev){
   auto event = std::make_shared<Ex0EventDataFormat>(*ev);
-  m_my_hist->Fill(event->GetQuantityX());
-  m_my_graph->SetPoint(m_my_graph->GetN(),
+  Fill(m_my_hist, event->GetQuantityX());
+  AddPoint(m_my_graph,
     event->GetQuantityX(), event->GetQuantityY(), event->GetQuantityZ());
-  m_my_prof->Fill(event->GetQuantityX(), event->GetQuantityY());
+  Fill(m_my_prof, event->GetQuantityX(), event->GetQuantityY());
 }
 
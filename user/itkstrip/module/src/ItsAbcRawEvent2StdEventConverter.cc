@@ -95,12 +95,16 @@ bool ItsAbcRawEvent2StdEventConverter::Converting(eudaq::EventSPC d1, eudaq::Std
       eudaq::StandardPlane plane(plane_id, "ITS_ABC", "ABC");
       // plane.SetSizeZS(channels.size(), 1, 0);//r0
       plane.SetSizeZS(1,channels.size(), 0);//ss
+      // strip indices can exceed 16 bits, keep them in full width
+      std::vector<uint32_t> xs, ys;
       for(size_t i = 0; i < channels.size(); ++i) {
 	if(channels[i]){
 	  // plane.PushPixel(i, 1 , 1);//r0
-	  plane.PushPixel(1, i , 1);//ss
+	  xs.push_back(1);//ss
+	  ys.push_back(i);
 	}
       }
+      plane.AppendHits(0, xs, ys);
       d2->AddPlane(plane);
     }
     else{
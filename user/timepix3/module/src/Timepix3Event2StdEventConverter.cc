@@ -85,20 +85,36 @@ bool Timepix3RawEvent2StdEventConverter::Converting(eudaq::EventSPC ev, eudaq::S
   bool data_found = false;
 
   // No event
-  if(!ev || ev->NumBlocks() < 1) {
+  if(!ev || (ev->NumBlocks() < 1 && ev->GetNumSubEvent() < 1)) {
     return false;
   }
 
-  // Retrieve data from Block 0:
+  // Retrieve data from Block 0, which holds all packets of one TDC interval.
+  // Files from older producers carry one packet per sub-event instead.
   std::vector<uint64_t> vpixdata;
-  auto data = ev->GetBlock(0);
-  vpixdata.resize(data.size() / sizeof(uint64_t));
-  memcpy(&vpixdata[0], &data[0], data.size());
+  auto append_block = [&vpixdata](const eudaq::Event &blockev) {
+    if(blockev.NumBlocks() < 1) {
+      return;
+    }
+    auto data = blockev.GetBlock(0);
+    size_t offset = vpixdata.size();
+    vpixdata.resize(offset + data.size() / sizeof(uint64_t));
+    if(vpixdata.size() > offset) {
+      memcpy(&vpixdata[offset], &data[0], (vpixdata.size() - offset) * sizeof(uint64_t));
+    }
+  };
+  append_block(*ev);
+  for(auto& subev : ev->GetSubEvents()) {
+    append_block(*subev);
+  }
 
   // Create a StandardPlane representing one sensor plane
   eudaq::StandardPlane plane(0, "SPIDR", "Timepix3");
   plane.SetSizeZS(256, 256, 0);
 
+  // at most one hit per packet, the plane does not grow while filling
+  plane.Reserve(0, vpixdata.size());
+
   // Event time stamps, defined by first and last pixel timestamp found in the data block:
   uint64_t event_begin = std::numeric_limits<uint64_t>::max(), event_end = std::numeric_limits<uint64_t>::lowest();
 
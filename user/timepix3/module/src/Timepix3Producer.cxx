@@ -932,7 +932,9 @@ void Timepix3Producer::RunLoop() {
       auto size = spidrdaq->sampleSize();
       //std::cout << "Got a sample of a size " << size << std::endl;
       // look inside sample buffer...
-      std::vector<eudaq::EventSPC> data_buffer;
+      // all packets up to the next TDC packet, sent as one block
+      std::vector<uint64_t> data_buffer;
+      data_buffer.reserve(size / sizeof(uint64_t));
       while(m_running) {
         uint64_t data = spidrdaq->nextPacket();
 
@@ -948,9 +950,7 @@ void Timepix3Producer::RunLoop() {
         if(header == 0x6) {
           // Send out pixel data accumulated so far:
           auto evup = eudaq::Event::MakeUnique("Timepix3RawEvent");
-          for(auto& subevt : data_buffer) {
-            evup->AddSubEvent(subevt);
-          }
+          evup->AddBlock(0, data_buffer);
           SendEvent(std::move(evup));
           //std::cout << "Sending 2 events with headers: " << listVector(header_counter) << endl;
           //header_counter.clear();
@@ -964,18 +964,14 @@ void Timepix3Producer::RunLoop() {
         } else {
           // pixel data OR timestamp (OR something else)
           // add it to the data_buffer
-          auto evup = eudaq::Event::MakeShared("Timepix3RawEvent");
-          evup->AddBlock(0, &data, sizeof(data));
-          data_buffer.push_back(evup);
+          data_buffer.push_back(data);
         }
       } // End loop over sample buffer
 
       // Send remaining pixel data:
       if(!data_buffer.empty()) {
         auto evup = eudaq::Event::MakeUnique("Timepix3RawEvent");
-        for(auto& subevt : data_buffer) {
-          evup->AddSubEvent(subevt);
-        }
+        evup->AddBlock(0, data_buffer);
         SendEvent(std::move(evup));
         //std::cout << "Sending event with headers: " << listVector(header_counter) << endl;
         //header_counter.clear();
@@ -1,4 +1,5 @@
 #include "eudaq/Producer.hh"
+#include "eudaq/TagKey.hh"
 
 #include "AidaTluController.hh"
 #include "AidaTluHardware.hh"
@@ -40,6 +41,16 @@ class AidaTluProducer: public eudaq::Producer {
 namespace{
   auto dummy0 = eudaq::Factory<eudaq::Producer>::
     Register<AidaTluProducer, const std::string&, const std::string&>(AidaTluProducer::m_id_factory);
+
+  // per-trigger tags, stored as integers under interned keys
+  const eudaq::TagKey TAG_FINE_TS[6] = {
+    eudaq::TagKey("FINE_TS0"), eudaq::TagKey("FINE_TS1"), eudaq::TagKey("FINE_TS2"),
+    eudaq::TagKey("FINE_TS3"), eudaq::TagKey("FINE_TS4"), eudaq::TagKey("FINE_TS5")};
+  const eudaq::TagKey TAG_SCALER[6] = {
+    eudaq::TagKey("SCALER0"), eudaq::TagKey("SCALER1"), eudaq::TagKey("SCALER2"),
+    eudaq::TagKey("SCALER3"), eudaq::TagKey("SCALER4"), eudaq::TagKey("SCALER5")};
+  const eudaq::TagKey TAG_TYPE("TYPE");
+  const eudaq::TagKey TAG_PARTICLES("PARTICLES");
 }
 
 
@@ -80,29 +91,25 @@ void AidaTluProducer::RunLoop(){
       ev->SetTimestamp(ts_ns, ts_ns+25, false);
       ev->SetTriggerN(trigger_n);
 
-      std::stringstream triggerss;
-      //triggerss<< data->input5 << data->input4 << data->input3 << data->input2 << data->input1 << data->input0;
-      triggerss<< std::to_string(data->input5) << std::to_string(data->input4) << std::to_string(data->input3) << std::to_string(data->input2) << std::to_string(data->input1) << std::to_string(data->input0);
-      ev->SetTag("TRIGGER", triggerss.str());
-      ev->SetTag("FINE_TS0", std::to_string(data->sc0));
-      ev->SetTag("FINE_TS1", std::to_string(data->sc1));
-      ev->SetTag("FINE_TS2", std::to_string(data->sc2));
-      ev->SetTag("FINE_TS3", std::to_string(data->sc3));
-      ev->SetTag("FINE_TS4", std::to_string(data->sc4));
-      ev->SetTag("FINE_TS5", std::to_string(data->sc5));
-      ev->SetTag("TYPE", std::to_string(data->eventtype));
+      const char trigger[] = {char('0' + data->input5), char('0' + data->input4),
+			      char('0' + data->input3), char('0' + data->input2),
+			      char('0' + data->input1), char('0' + data->input0), 0};
+      ev->SetTag("TRIGGER", std::string(trigger));
+      ev->SetTag(TAG_FINE_TS[0], data->sc0);
+      ev->SetTag(TAG_FINE_TS[1], data->sc1);
+      ev->SetTag(TAG_FINE_TS[2], data->sc2);
+      ev->SetTag(TAG_FINE_TS[3], data->sc3);
+      ev->SetTag(TAG_FINE_TS[4], data->sc4);
+      ev->SetTag(TAG_FINE_TS[5], data->sc5);
+      ev->SetTag(TAG_TYPE, data->eventtype);
 
       if(m_tlu->IsBufferEmpty()){
-      	uint32_t sl0,sl1,sl2,sl3, sl4, sl5, pt;
-      	m_tlu->GetScaler(sl0,sl1,sl2,sl3,sl4,sl5);
+      	uint32_t sl[6], pt;
+      	m_tlu->GetScaler(sl[0],sl[1],sl[2],sl[3],sl[4],sl[5]);
       	pt=m_tlu->GetPreVetoTriggers();
-        ev->SetTag("PARTICLES", std::to_string(pt));
-      	ev->SetTag("SCALER0", std::to_string(sl0));
-      	ev->SetTag("SCALER1", std::to_string(sl1));
-      	ev->SetTag("SCALER2", std::to_string(sl2));
-      	ev->SetTag("SCALER3", std::to_string(sl3));
-        ev->SetTag("SCALER4", std::to_string(sl4));
-        ev->SetTag("SCALER5", std::to_string(sl5));
+        ev->SetTag(TAG_PARTICLES, pt);
+        for(int i = 0; i < 6; i++)
+          ev->SetTag(TAG_SCALER[i], sl[i]);
         if(m_exit_of_run){
           ev->SetEORE();
         }